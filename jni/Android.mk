@@ -13,7 +13,18 @@ include $(OPENCV_MK_PATH)
 
 
 LOCAL_MODULE    := mixed_sample
-LOCAL_SRC_FILES := calibration_wrap.cpp MutualCalibration.cpp Chessboard.cpp CataCameraParameters.cpp Cas1DVanishingPoint.cpp RansacVanishingPoint.cpp
+LOCAL_SRC_FILES := calibration_wrap.cpp MutualCalibration.cpp Chessboard.cpp CataCameraParameters.cpp Cas1DVanishingPoint.cpp RansacVanishingPoint.cpp OnlineFocalEstimator.cpp Histogram1D.cpp VanishingPointEngine.cpp VanishingPointTracker.cpp LinePairFilter.cpp FramePipeline.cpp Overlay.cpp IMURingBuffer.cpp IMUHistory.cpp IncrementalKabsch.cpp Log.cpp MappedFile.cpp SessionLog.cpp FrameRecorder.cpp KeyframeSelector.cpp IncrementalIntrinsics.cpp ViewRefinement.cpp UndistortionMap.cpp CataCamera.cpp CalibrationFile.cpp
 LOCAL_CFLAGS    := -frtti
 LOCAL_LDLIBS +=  -llog -ldl
+
+# ARMv7 devices may lack NEON, the CataCamera kernels are built with it in
+# their own file and picked at run time
+ifeq ($(TARGET_ARCH_ABI),armeabi-v7a)
+LOCAL_SRC_FILES += CataCameraNeon.cpp.neon
+LOCAL_CFLAGS    += -DCATACAMERA_NEON_DISPATCH
+LOCAL_STATIC_LIBRARIES += cpufeatures
+endif
+
 include $(BUILD_SHARED_LIBRARY)
+
+$(call import-module,android/cpufeatures)
@@ -0,0 +1,140 @@
+#include "CalibrationFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace
+{
+
+const uint32_t CALIBRATION_VERSION = 1; 
+
+// CRC-32 as in zlib, polynomial 0xEDB88320, one table lookup per byte
+struct CrcTable
+{
+	uint32_t entries[256]; 
+
+	CrcTable()
+	{
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t c = i; 
+			for (int k = 0; k < 8; k++)
+				c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1; 
+			entries[i] = c; 
+		}
+	}
+}; 
+
+const CrcTable crcTable; 
+
+uint32_t
+crc32(const void * data, size_t size)
+{
+	const unsigned char * p = static_cast<const unsigned char *>(data); 
+	uint32_t c = 0xFFFFFFFFu; 
+	for (size_t i = 0; i < size; i++)
+		c = crcTable.entries[(c ^ p[i]) & 0xFF] ^ (c >> 8); 
+	return c ^ 0xFFFFFFFFu; 
+}
+
+}
+
+CalibrationRecord
+createCalibrationRecord(int imageWidth, int imageHeight)
+{
+	CalibrationRecord record; 
+	memset(&record, 0, sizeof(record)); 
+	memcpy(record.magic, "MCCB", 4); 
+	record.version = CALIBRATION_VERSION; 
+	record.imageWidth = imageWidth; 
+	record.imageHeight = imageHeight; 
+
+	struct timespec ts; 
+	clock_gettime(CLOCK_REALTIME, &ts); 
+	record.timestamp = (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec; 
+	return record; 
+}
+
+void
+setCataParameters(CalibrationRecord & record, const vcharge::CataCameraParameters & params)
+{
+	record.flags |= CALIBRATION_CATA; 
+	record.imageWidth = params.imageWidth(); 
+	record.imageHeight = params.imageHeight(); 
+	memset(record.cameraName, 0, sizeof(record.cameraName)); 
+	strncpy(record.cameraName, params.cameraName().c_str(), sizeof(record.cameraName) - 1); 
+
+	double values[9] = { params.xi(), params.k1(), params.k2(), params.p1(), params.p2(),
+						 params.gamma1(), params.gamma2(), params.u0(), params.v0() }; 
+	memcpy(record.cata, values, sizeof(values)); 
+}
+
+bool
+getCataParameters(const CalibrationRecord & record, vcharge::CataCameraParameters & params)
+{
+	if (!(record.flags & CALIBRATION_CATA)) return false; 
+	const double * c = record.cata; 
+	params = vcharge::CataCameraParameters(record.imageWidth, record.imageHeight,
+										   c[0], c[1], c[2], c[3], c[4], c[5], c[6], c[7], c[8]); 
+	// the name may fill the field without a terminator in a damaged file
+	const char * end = static_cast<const char *>(memchr(record.cameraName, 0, sizeof(record.cameraName))); 
+	params.cameraName().assign(record.cameraName, end ? end : record.cameraName + sizeof(record.cameraName)); 
+	return true; 
+}
+
+void
+sealCalibrationRecord(CalibrationRecord & record)
+{
+	record.crc = crc32(&record, offsetof(CalibrationRecord, crc)); 
+}
+
+bool
+checkCalibrationRecord(const CalibrationRecord & record)
+{
+	return memcmp(record.magic, "MCCB", 4) == 0 && record.version == CALIBRATION_VERSION
+		&& record.crc == crc32(&record, offsetof(CalibrationRecord, crc)); 
+}
+
+bool
+writeCalibrationFile(const char * path, const CalibrationRecord * records, size_t n, bool append)
+{
+	if (!path) return false; 
+	FILE * file = fopen(path, append ? "ab" : "wb"); 
+	if (!file) return false; 
+	bool written = (n == 0 || fwrite(records, sizeof(CalibrationRecord), n, file) == n); 
+	return fclose(file) == 0 && written; 
+}
+
+bool
+CalibrationFileReader::open(const char * path)
+{
+	if (!mFile.open(path)) return false; 
+	if (mFile.size() % sizeof(CalibrationRecord) != 0)
+	{
+		mFile.close(); 
+		return false; 
+	}
+	return true; 
+}
+
+void
+CalibrationFileReader::close()
+{
+	mFile.close(); 
+}
+
+size_t
+CalibrationFileReader::getNumberOfRecords() const
+{
+	return mFile.size() / sizeof(CalibrationRecord); 
+}
+
+const CalibrationRecord *
+CalibrationFileReader::getRecord(size_t i) const
+{
+	if (i >= getNumberOfRecords()) return NULL; 
+	// mmap returns page aligned memory and the records are multiples of 8
+	const CalibrationRecord * record = reinterpret_cast<const CalibrationRecord *>(mFile.data()) + i; 
+	return checkCalibrationRecord(*record) ? record : NULL; 
+}
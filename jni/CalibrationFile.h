@@ -0,0 +1,63 @@
+#ifndef CALIBRATIONFILE_H
+#define CALIBRATIONFILE_H
+
+#include <cstddef>
+#include <stdint.h>
+
+#include "CataCameraParameters.h"
+#include "MappedFile.h"
+
+#define CALIBRATION_CATA 1				// cata holds a CataCameraParameters
+#define CALIBRATION_CAMERA_MATRIX 2		// cameraMatrix and distortion, from calibrateCamera
+#define CALIBRATION_ROTATION 4			// camera to imu, from mutualCalibrate
+
+// One calibration, fixed size and 8 byte aligned. A file is one or more of
+// them back to back, so that a file with the calibrations of many devices
+// is read in place from a mapping and record i is at i * sizeof(record).
+// The crc covers every byte before it; the YAML of
+// CataCameraParameters::write stays the readable form.
+struct CalibrationRecord
+{
+	char magic[4];						// "MCCB"
+	uint32_t version; 
+	uint32_t flags;						// CALIBRATION_*
+	uint32_t reserved; 
+	int64_t timestamp;					// nanoseconds since the epoch
+	int32_t imageWidth, imageHeight; 
+	char cameraName[32];				// zero terminated
+
+	double cata[9];						// xi, k1, k2, p1, p2, gamma1, gamma2, u0, v0
+	double cameraMatrix[9];				// row by row
+	double distortion[5];				// k1, k2, p1, p2, k3 as cv::calibrateCamera
+	double rotation[9];					// row by row
+
+	uint32_t crc; 
+	uint32_t padding; 
+}; 
+
+CalibrationRecord createCalibrationRecord(int imageWidth, int imageHeight); 
+void setCataParameters(CalibrationRecord & record, const vcharge::CataCameraParameters & params); 
+bool getCataParameters(const CalibrationRecord & record, vcharge::CataCameraParameters & params); 
+
+// fills in the crc, to be called last
+void sealCalibrationRecord(CalibrationRecord & record); 
+bool checkCalibrationRecord(const CalibrationRecord & record); 
+
+bool writeCalibrationFile(const char * path, const CalibrationRecord * records, size_t n, bool append = false); 
+
+// Reader over a mapped calibration file; the records point into the mapping
+// and are valid until the reader is closed.
+class CalibrationFileReader
+{
+	MappedFile mFile; 
+
+public:
+	bool open(const char * path); 
+	void close(); 
+
+	size_t getNumberOfRecords() const; 
+	// NULL if the record is damaged
+	const CalibrationRecord * getRecord(size_t i) const; 
+}; 
+
+#endif
@@ -1,13 +1,14 @@
 #include "Cas1DVanishingPoint.h"
+#include "Histogram1D.h"
 
 #include <cmath>
 #include <algorithm>
-#include <iostream>
 #include <opencv2/imgproc/imgproc.hpp>
-#include <opencv2/highgui/highgui.hpp>
-#include <fstream>
 
-//#include <android/log.h>
+#include "Log.h"
+#if LOG_SHOW_IMAGES
+#include <opencv2/highgui/highgui.hpp>
+#endif
 
 std::vector<size_t>
 Cas1DVanishingPoint::randPerm(size_t n) const 
@@ -17,7 +18,7 @@ Cas1DVanishingPoint::randPerm(size_t n) const
 
 	for(size_t i = 0; i < n; i++) 
 	{	
-		size_t j = rand() % (n - i) + i;
+		size_t j = (*mRng)(n - i) + i;
 
 		size_t t = perm[j];
 		perm[j] = perm[i];
@@ -27,16 +28,18 @@ Cas1DVanishingPoint::randPerm(size_t n) const
 	return perm; 
 }
 
-Cas1DVanishingPoint::Cas1DVanishingPoint(const cv::Mat & image)
+Cas1DVanishingPoint::Cas1DVanishingPoint(const cv::Mat & image, const UndistortionMap * undistortion, cv::RNG * rng)
+	: mSmoothVotes(false), mRng(rng ? rng : &cv::theRNG())
 {
 	if (image.channels() > 1)	
 		cv::cvtColor(image, mImage, CV_BGR2GRAY); 
 	else image.copyTo(mImage); 
-	cv::cvtColor(mImage, mSketch, CV_GRAY2BGR); 
 
 	mInteriorRadius = hypot(mImage.cols / 2, mImage.rows / 2); 
 
 	detectLines(); 
+	// only the endpoints are undistorted, through the table
+	if (undistortion) undistortion->undistortLines(mLines); 
 	for (size_t i = 0; i < mLines.size(); i++)
 	{
 		mLines[i][0] -= mImage.cols / 2; 
@@ -47,6 +50,12 @@ Cas1DVanishingPoint::Cas1DVanishingPoint(const cv::Mat & image)
 //	showLines(mLines); 
 }
 
+void
+Cas1DVanishingPoint::setSmoothVotes(bool smooth)
+{
+	mSmoothVotes = smooth; 
+}
+
 bool 
 Cas1DVanishingPoint::focalAvailable() const
 {
@@ -76,6 +85,39 @@ Cas1DVanishingPoint::getVanishingPts() const
 	return mVanishingPts; 
 }
 
+const std::vector<cv::Vec4i> &
+Cas1DVanishingPoint::getLines() const
+{
+	// centred on the image, undistorted if a table was given
+	return mLines; 
+}
+
+size_t
+Cas1DVanishingPoint::getNumberOfLines() const
+{
+	return mLines.size(); 
+}
+
+size_t
+Cas1DVanishingPoint::getSupport() const
+{
+	if (!threeDetected()) return 0; 
+	size_t support = 0; 
+	for (size_t i = 0; i < mVanishingPts.size(); i++)
+	{
+		float theta = atan2(mVanishingPts[i].y, mVanishingPts[i].x); 
+		float rho = hypot(mVanishingPts[i].x, mVanishingPts[i].y); 
+		support += linesSupport(theta, rho, mLines).size(); 
+	}
+	return support; 
+}
+
+const LinePairStats &
+Cas1DVanishingPoint::getLinePairStats() const
+{
+	return mPairStats; 
+}
+
 cv::Mat
 Cas1DVanishingPoint::getRotation() const
 {
@@ -91,12 +133,10 @@ Cas1DVanishingPoint::getRotation() const
 			R.at<double>(2, i) = -mFocal / len; 
 		}
 
-/*			__android_log_print(
-			ANDROID_LOG_INFO, "vR", "%lf %lf %lf \n   %lf %lf %lf \n %lf %lf %lf\n",
+		LOGV("vR", "%lf %lf %lf \n   %lf %lf %lf \n %lf %lf %lf\n",
 			R.at<double>(0, 0), R.at<double>(0, 1), R.at<double>(0, 2),
 			R.at<double>(1, 0), R.at<double>(1, 1), R.at<double>(1, 2),
 			R.at<double>(2, 0), R.at<double>(2, 1), R.at<double>(2, 2));
-*/
 		return R * 1.0; 
 	}
 	else if (mMessage == THREE_DETECTED_WITH_TWO_INFINITE)
@@ -112,40 +152,47 @@ cv::Mat
 Cas1DVanishingPoint::getSketch() const
 {
 	cv::Mat m; 
-	mSketch.copyTo(m); 
-	if (threeDetected())
-	{
-		for (size_t i = 0; i < mVanishingPts.size(); i++)
-		{
-			cv::Point2f v; 
-			v = mVanishingPts[i];  
-			cv::line(m, cv::Point(m.cols/2, m.rows/2), 
-					cv::Point(v.x + m.cols/2, v.y + m.rows/2), cv::Scalar(255, 255, 0), 3, 8);
-		}
-	}
-	return m * 1.0; 
+	cv::cvtColor(mImage, m, CV_GRAY2BGR); 
+	Overlay overlay; 
+	getOverlay(overlay); 
+	overlay.draw(m); 
+	return m; 
+}
+
+void
+Cas1DVanishingPoint::getOverlay(Overlay & overlay) const
+{
+	if (!threeDetected()) return; 
+	cv::Point2f c(mImage.cols/2, mImage.rows/2); 
+	for (size_t i = 0; i < mVanishingPts.size(); i++)
+		overlay.addSegment(c, c + mVanishingPts[i], cv::Scalar(255, 255, 0), 3.0f); 
 }
 
 
 void 
 Cas1DVanishingPoint::showLines(const std::vector<cv::Vec4i> & lines) const
 {
+#if LOG_SHOW_IMAGES
 		cv::namedWindow("lines", CV_WINDOW_KEEPRATIO); 
 		cv::Mat m; 
-		mSketch.copyTo(m); 
+		cv::cvtColor(mImage, m, CV_GRAY2BGR); 
 		for (size_t i = 0; i < lines.size(); i++)
 			cv::line(m, cv::Point(lines[i][0] + m.cols/2, lines[i][1] + m.rows/2), 
 					cv::Point(lines[i][2] + m.cols/2, lines[i][3] + m.rows/2), cv::Scalar(255, 255, 0), 1, 8);
 		cv::imshow("lines", m); 
 		cv::waitKey(); 
+#else
+	(void)lines; 
+#endif
 }
 
 void
 Cas1DVanishingPoint::showVanishing(const std::vector<cv::Point2f> & vanishingPts) const
 {
+#if LOG_SHOW_IMAGES
 		cv::namedWindow("v", CV_WINDOW_KEEPRATIO); 
 		cv::Mat m; 
-		mSketch.copyTo(m); 
+		cv::cvtColor(mImage, m, CV_GRAY2BGR); 
 		for (size_t i = 0; i < vanishingPts.size(); i++)
 		{
 			cv::Point2f v; 
@@ -155,6 +202,9 @@ Cas1DVanishingPoint::showVanishing(const std::vector<cv::Point2f> & vanishingPts
 		}
 		cv::imshow("v", m); 
 		cv::waitKey(); 
+#else
+	(void)vanishingPts; 
+#endif
 }
 
 double 
@@ -218,15 +268,21 @@ Cas1DVanishingPoint::convergeLines(const std::vector<cv::Vec4i> & lines) const
 std::vector<cv::Point2f>
 Cas1DVanishingPoint::intersectLines(const std::vector<cv::Vec4i> & lines) const
 {
+	LinePairFilter filter; 
+	filter.setLines(lines); 
+
 	std::vector<cv::Point2f> intersections; 
 	for (size_t i = 0; i < lines.size(); i++)
 		for (size_t j = i + 1; j < lines.size(); j++)
 		{
+			if (!filter.accept(i, j)) continue; 
+
 			std::vector<cv::Vec4i> two_lines; 
 			two_lines.push_back(lines[i]); 
 			two_lines.push_back(lines[j]); 
 			intersections.push_back(convergeLines(two_lines)); 
 		}
+	mPairStats += filter.getStats(); 
 	return intersections; 
 }
 
@@ -277,27 +333,12 @@ Cas1DVanishingPoint::findTheta(const std::vector<float> & thetas, std::vector<si
 {
 	float theta_threshold = 5.0f / 360 * CV_PI; 
 
-	int channel = 0; 	
 	int histSize = std::max((int)thetas.size() / 2, 90); 
-	float histRange[] = {-CV_PI, CV_PI}; 
-	const float *histRanges[] = {histRange}; 
-	cv::Mat data(thetas); 
-	cv::Mat hist; 
-	cv::calcHist(&data, 1, &channel, cv::Mat(), hist, 1, &histSize, histRanges, true, false); 
-
-	cv::Point max_loc; 
-	cv::minMaxLoc(hist, NULL, NULL, NULL, &max_loc); 
-	float theta = histRange[0] + max_loc.y * (histRange[1] - histRange[0]) / histSize; 
-//	std::cout << hist << "--" << theta << std::endl; 
-
-	for (size_t i = 0; i < thetas.size(); i++)
-	{
-		if (fabs(thetas[i] - theta) < theta_threshold |
-			2.0f * CV_PI - fabs(thetas[i] - theta) < theta_threshold)
-		{
-			supportIndex.push_back(i); 
-		}
-	}
+	Histogram1D hist(-CV_PI, CV_PI, histSize, true); 
+	int max_loc = hist.vote(thetas, mSmoothVotes); 
+	float theta = hist.binLower(max_loc); 
+
+	hist.support(theta, theta_threshold, supportIndex); 
 
 	return theta; 
 }
@@ -310,18 +351,9 @@ Cas1DVanishingPoint::findRho(const std::vector<float> & rhos, const std::vector<
 	for (size_t i = 0; i < supportIndex.size(); i++)
 		phis.push_back(atan2(rhos[supportIndex[i]], z)); 
 
-	int channel = 0; 	
 	int histSize = rhos.size() < 90 ? 23 : 90;  
-	float histRange[] = {0.0f, 0.5f * CV_PI}; 
-	const float *histRanges[] = {histRange}; 
-	cv::Mat data(phis); 
-	cv::Mat hist; 
-	cv::calcHist(&data, 1, &channel, cv::Mat(), hist, 1, &histSize, histRanges, true, false); 
-
-//	std::cout << hist << std::endl; 
-	cv::Point max_loc; 
-	cv::minMaxLoc(hist, NULL, NULL, NULL, &max_loc); 
-	float phi = histRange[0] + (0.5 + max_loc.y) * (histRange[1] - histRange[0]) / histSize; 
+	Histogram1D hist(0.0f, 0.5f * CV_PI, histSize); 
+	float phi = hist.binCenter(hist.vote(phis, mSmoothVotes)); 
 	float rho = z * tan(phi); 
 	return rho; 
 }
@@ -351,13 +383,30 @@ Cas1DVanishingPoint::findInteriorVanishingPt(const std::vector<cv::Vec4i> & line
 	size_t max_iter = 1000; 
 	size_t it = 0; 
 	size_t max_inliers = 2; 
-	float best_theta, best_rho; 
+	float best_theta = 0, best_rho = 0; 
+	if (lines.size() < 2)
+	{
+		intVPTheta = best_theta; 
+		intVPRho = best_rho; 
+		return; 
+	}
+
+	LinePairFilter filter; 
+	filter.setLines(lines); 
 	while (it < k && it < max_iter)
 	{
-		std::vector<size_t> perm = randPerm(lines.size()); 
+		// rejected pairs are redrawn, an iteration is only used up when the
+		// pairs drawn were all rejected
+		size_t i, j; 
+		if (!filter.samplePair(*mRng, i, j))
+		{
+			it++; 
+			continue; 
+		}
+
 		std::vector<cv::Vec4i> samples; 
-		samples.push_back(lines[perm[0]]); 
-		samples.push_back(lines[perm[1]]); 
+		samples.push_back(lines[i]); 
+		samples.push_back(lines[j]); 
 		cv::Point2f guess = convergeLines(samples); 
 		float th = atan2(guess.y, guess.x); 
 		float rh = hypot(guess.x, guess.y); 
@@ -379,6 +428,7 @@ Cas1DVanishingPoint::findInteriorVanishingPt(const std::vector<cv::Vec4i> & line
 //		std::cout << k << " " << it  << std::endl; 
 		it++; 
 	}
+	mPairStats += filter.getStats(); 
 	intVPTheta = best_theta; 
 	intVPRho = best_rho; 
 
@@ -441,7 +491,9 @@ Cas1DVanishingPoint::findInteriorVanishingPt(const std::vector<cv::Point2f> & pt
 			yWeights[i] = 0.0f; 
 
 	}
-	std::cout << cv::Mat(xWeights) << std::endl; 
+	if (LOG_ENABLED(LOG_LEVEL_VERBOSE))
+		for (size_t i = 0; i < histSize; i++)
+			LOGV("Cas1DVanishingPoint", "x weight %d: %f", (int)i, xWeights[i]); 
 	size_t xIndex = 0, yIndex = 0; 
 	for (size_t i = 0; i < histSize; i++)
 	{
@@ -498,6 +550,7 @@ Cas1DVanishingPoint::findOrthogonalVanishingPts()
 
 	std::vector<cv::Vec4i> remaining_lines(mLines); 
 	bool interiorUsed = false; 
+	mPairStats = LinePairStats(); 
 	
 	std::vector<cv::Point2f> vanishingPts; 
 	std::vector<float> vanishingThetas, vanishingRhos; 
@@ -716,18 +769,9 @@ Cas1DVanishingPoint::refineVanishingPts(const std::vector<cv::Point2f> & pts, co
 	for (size_t i = 0; i < focals.size(); i++)
 		phis.push_back(atan2(focals[i], z)); 
 
-	int channel = 0; 	
 	int histSize = phis.size() < 90 ? 45 : 90;  
-	float histRange[] = {0.0f, 0.5f * CV_PI}; 
-	const float *histRanges[] = {histRange}; 
-	cv::Mat data(phis); 
-	cv::Mat hist; 
-	cv::calcHist(&data, 1, &channel, cv::Mat(), hist, 1, &histSize, histRanges, true, false); 
-
-//	std::cout << hist << std::endl; 
-	cv::Point max_loc; 
-	cv::minMaxLoc(hist, NULL, NULL, NULL, &max_loc); 
-	float phi = histRange[0] + max_loc.y * (histRange[1] - histRange[0]) / histSize; 
+	Histogram1D hist(0.0f, 0.5f * CV_PI, histSize); 
+	float phi = hist.binLower(hist.vote(phis, mSmoothVotes)); 
 
 	focal = z * tan(phi); 
 	vanishingRhos[0] = focal * d0; 
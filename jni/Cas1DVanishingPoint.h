@@ -1,5 +1,12 @@
+#ifndef CAS1DVANISHINGPOINT_H
+#define CAS1DVANISHINGPOINT_H
+
 #include <opencv2/core/core.hpp>
 
+#include "LinePairFilter.h"
+#include "Overlay.h"
+#include "UndistortionMap.h"
+
 #define NOTHING_DETECTED 0
 #define ONE_DETECTED 1
 #define TWO_DETECTED 2
@@ -13,16 +20,20 @@
 class Cas1DVanishingPoint
 {
 	cv::Mat mImage; 
-	cv::Mat mSketch; 
 	std::vector<cv::Vec4i> mLines; 
 	std::vector<cv::Point2f> mVanishingPts; 
 	float mInteriorRadius; 
 	float mFocal; 
 	cv::Point2f mPrinciplePt; 
 	int mMessage; 
+	bool mSmoothVotes; 
+	mutable LinePairStats mPairStats; 
+	cv::RNG * mRng; 
 
 public: 
-	Cas1DVanishingPoint(const cv::Mat & image); 
+	Cas1DVanishingPoint(const cv::Mat & image, const UndistortionMap * undistortion = NULL, cv::RNG * rng = NULL); 
+
+	void setSmoothVotes(bool smooth); 
 
 	bool focalAvailable() const; 
 	float getFocal() const; 
@@ -30,9 +41,14 @@ public:
 	bool threeDetected() const; 
 
 	cv::Mat getSketch() const; 
+	void getOverlay(Overlay & overlay) const; 
 
 	void findOrthogonalVanishingPts(); 
 	std::vector<cv::Point2f> getVanishingPts() const; 
+	const std::vector<cv::Vec4i> & getLines() const; 
+	size_t getNumberOfLines() const; 
+	size_t getSupport() const; 
+	const LinePairStats & getLinePairStats() const; 
 	cv::Mat getRotation() const; 
 
 	void 
@@ -76,3 +92,4 @@ protected:
 		refineVanishingPts(const std::vector<cv::Point2f> & pts, const std::vector<float> & vanishingThetas, std::vector<float> & vanishingRhos, float & focal) const; 
 };
 
+#endif
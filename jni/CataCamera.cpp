@@ -0,0 +1,181 @@
+#include "CataCamera.h"
+
+#include <cmath>
+
+#include "CataCameraKernels.h"
+
+#ifdef CATACAMERA_NEON_DISPATCH
+#include <cpu-features.h>
+#endif
+
+namespace vcharge
+{
+
+#ifdef CATACAMERA_NEON_DISPATCH
+
+namespace
+{
+
+bool
+neonAvailable(void)
+{
+	// ARMv7 does not guarantee NEON, the kernels are only used if the CPU
+	// reports it; the check is made once
+	static int available = -1;
+	if (available < 0)
+	{
+		available = android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM
+			&& (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0;
+	}
+	return available != 0;
+}
+
+}
+
+#endif
+
+CataCamera::CataCamera()
+ : m_inv_gamma1(0.0)
+ , m_inv_gamma2(0.0)
+{
+
+}
+
+CataCamera::CataCamera(const CataCameraParameters& params)
+{
+	setParameters(params);
+}
+
+const CataCameraParameters&
+CataCamera::parameters(void) const
+{
+	return m_params;
+}
+
+void
+CataCamera::setParameters(const CataCameraParameters& params)
+{
+	m_params = params;
+	m_inv_gamma1 = 1.0 / params.gamma1();
+	m_inv_gamma2 = 1.0 / params.gamma2();
+}
+
+void
+CataCamera::liftProjective(const cv::Point2d& p, cv::Point3d& P) const
+{
+	double xi = m_params.xi();
+
+	// to the distorted normalised plane, then undo the distortion
+	cv::Point2d m_d((p.x - m_params.u0()) * m_inv_gamma1, (p.y - m_params.v0()) * m_inv_gamma2);
+	cv::Point2d m_u = m_d, d_u;
+	for (int i = 0; i < UNDISTORT_ITERATIONS; ++i)
+	{
+		distortion(m_u, d_u);
+		m_u = m_d - d_u;
+	}
+
+	// onto the sphere
+	double rho2 = m_u.x * m_u.x + m_u.y * m_u.y;
+	double lambda = (xi + sqrt(1.0 + (1.0 - xi * xi) * rho2)) / (1.0 + rho2);
+	P = cv::Point3d(lambda * m_u.x, lambda * m_u.y, lambda - xi);
+}
+
+void
+CataCamera::spaceToPlane(const cv::Point3d& P, cv::Point2d& p) const
+{
+	double norm = sqrt(P.x * P.x + P.y * P.y + P.z * P.z);
+	double z = P.z + m_params.xi() * norm;
+	cv::Point2d m_u(P.x / z, P.y / z), d_u;
+
+	distortion(m_u, d_u);
+	p = cv::Point2d(m_params.gamma1() * (m_u.x + d_u.x) + m_params.u0(),
+					m_params.gamma2() * (m_u.y + d_u.y) + m_params.v0());
+}
+
+void
+CataCamera::distortion(const cv::Point2d& p_u, cv::Point2d& d_u) const
+{
+	double k1 = m_params.k1();
+	double k2 = m_params.k2();
+	double p1 = m_params.p1();
+	double p2 = m_params.p2();
+
+	double mx2_u = p_u.x * p_u.x;
+	double my2_u = p_u.y * p_u.y;
+	double mxy_u = p_u.x * p_u.y;
+	double rho2_u = mx2_u + my2_u;
+	double rad_dist_u = k1 * rho2_u + k2 * rho2_u * rho2_u;
+	d_u = cv::Point2d(p_u.x * rad_dist_u + 2.0 * p1 * mxy_u + p2 * (rho2_u + 2.0 * mx2_u),
+					  p_u.y * rad_dist_u + 2.0 * p2 * mxy_u + p1 * (rho2_u + 2.0 * my2_u));
+}
+
+void
+CataCamera::liftProjective(const float* uv, float* xyz, size_t n) const
+{
+	size_t i = 0;
+#if defined(CATACAMERA_SIMD)
+	i = liftProjectiveBatch(m_params, uv, xyz, n);
+#elif defined(CATACAMERA_NEON_DISPATCH)
+	if (neonAvailable())
+	{
+		i = liftProjectiveNeon(m_params, uv, xyz, n);
+	}
+#endif
+	for (; i < n; ++i)
+	{
+		liftProjective(uv + 2 * i, xyz + 3 * i);
+	}
+}
+
+void
+CataCamera::spaceToPlane(const float* xyz, float* uv, size_t n) const
+{
+	size_t i = 0;
+#if defined(CATACAMERA_SIMD)
+	i = spaceToPlaneBatch(m_params, xyz, uv, n);
+#elif defined(CATACAMERA_NEON_DISPATCH)
+	if (neonAvailable())
+	{
+		i = spaceToPlaneNeon(m_params, xyz, uv, n);
+	}
+#endif
+	for (; i < n; ++i)
+	{
+		spaceToPlane(xyz + 3 * i, uv + 2 * i);
+	}
+}
+
+const char*
+CataCamera::simdName(void)
+{
+#if defined(__ARM_NEON__)
+	return "neon";
+#elif defined(__SSE2__)
+	return "sse2";
+#elif defined(CATACAMERA_NEON_DISPATCH)
+	return neonAvailable() ? "neon" : "scalar";
+#else
+	return "scalar";
+#endif
+}
+
+void
+CataCamera::liftProjective(const float* uv, float* xyz) const
+{
+	cv::Point3d P;
+	liftProjective(cv::Point2d(uv[0], uv[1]), P);
+	xyz[0] = P.x;
+	xyz[1] = P.y;
+	xyz[2] = P.z;
+}
+
+void
+CataCamera::spaceToPlane(const float* xyz, float* uv) const
+{
+	cv::Point2d p;
+	spaceToPlane(cv::Point3d(xyz[0], xyz[1], xyz[2]), p);
+	uv[0] = p.x;
+	uv[1] = p.y;
+}
+
+}
@@ -0,0 +1,56 @@
+#ifndef CATACAMERA_H
+#define CATACAMERA_H
+
+#include <cstddef>
+#include <opencv2/core/core.hpp>
+
+#include "CataCameraParameters.h"
+
+namespace vcharge
+{
+
+// Projection and back-projection of the unified (Mei) camera model described
+// by CataCameraParameters: a point goes onto the unit sphere, is projected
+// from (0, 0, -xi), distorted with k1, k2, p1, p2 and mapped to pixels with
+// gamma1, gamma2, u0, v0.
+//
+// The batched functions take contiguous interleaved arrays (u v u v ...,
+// x y z x y z ...) and process four points at a time with NEON or SSE2 when
+// the file is built with them, with the scalar code below for the rest.
+class CataCamera
+{
+public:
+	CataCamera();
+	explicit CataCamera(const CataCameraParameters& params);
+
+	const CataCameraParameters& parameters(void) const;
+	void setParameters(const CataCameraParameters& params);
+
+	// pixel to a ray, not normalised, with z = lambda - xi as in the paper;
+	// the distortion is inverted by fixed point iterations
+	void liftProjective(const cv::Point2d& p, cv::Point3d& P) const;
+	// point in the camera frame to pixel
+	void spaceToPlane(const cv::Point3d& P, cv::Point2d& p) const;
+	// distortion offset of a point on the normalised plane
+	void distortion(const cv::Point2d& p_u, cv::Point2d& d_u) const;
+
+	void liftProjective(const float* uv, float* xyz, size_t n) const;
+	void spaceToPlane(const float* xyz, float* uv, size_t n) const;
+
+	// which batched kernels are in use: "neon", "sse2" or "scalar"
+	static const char* simdName(void);
+
+	enum { UNDISTORT_ITERATIONS = 8 };
+
+private:
+	void liftProjective(const float* uv, float* xyz) const;
+	void spaceToPlane(const float* xyz, float* uv) const;
+
+	CataCameraParameters m_params;
+	double m_inv_gamma1;
+	double m_inv_gamma2;
+};
+
+}
+
+#endif
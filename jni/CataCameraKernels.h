@@ -0,0 +1,263 @@
+#ifndef CATACAMERAKERNELS_H
+#define CATACAMERAKERNELS_H
+
+// The batched CataCamera kernels, four points at a time. Included by
+// CataCamera.cpp, which uses them directly when it is itself built with SSE2
+// or NEON, and by CataCameraNeon.cpp, which is built with NEON for ARMv7 and
+// only called when the CPU has it.
+
+#include <cstddef>
+
+#include "CataCamera.h"
+
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define CATACAMERA_SIMD 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define CATACAMERA_SIMD 1
+#endif
+
+namespace vcharge
+{
+
+#ifdef CATACAMERA_NEON_DISPATCH
+// in CataCameraNeon.cpp; the number of points done, a multiple of four
+size_t liftProjectiveNeon(const CataCameraParameters& params, const float* uv, float* xyz, size_t n);
+size_t spaceToPlaneNeon(const CataCameraParameters& params, const float* xyz, float* uv, size_t n);
+#endif
+
+#ifdef CATACAMERA_SIMD
+
+namespace
+{
+
+// the few operations the kernels need, four floats at a time
+#if defined(__ARM_NEON__)
+
+typedef float32x4_t float4;
+
+inline float4 set4(float a) { return vdupq_n_f32(a); }
+inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+
+inline float4
+div4(float4 a, float4 b)
+{
+	// no divide on ARMv7, two Newton steps refine the reciprocal estimate
+	float4 r = vrecpeq_f32(b);
+	r = vmulq_f32(vrecpsq_f32(b, r), r);
+	r = vmulq_f32(vrecpsq_f32(b, r), r);
+	return vmulq_f32(a, r);
+}
+
+inline float4
+sqrt4(float4 a)
+{
+	// a times the refined reciprocal square root, which is infinite at 0
+	float4 e = vrsqrteq_f32(a);
+	e = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, e), e), e);
+	e = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, e), e), e);
+	float4 zero = vdupq_n_f32(0.0f);
+	return vbslq_f32(vceqq_f32(a, zero), zero, vmulq_f32(a, e));
+}
+
+inline void
+load2(const float* p, float4& a, float4& b)
+{
+	float32x4x2_t v = vld2q_f32(p);
+	a = v.val[0];
+	b = v.val[1];
+}
+
+inline void
+store2(float* p, float4 a, float4 b)
+{
+	float32x4x2_t v;
+	v.val[0] = a;
+	v.val[1] = b;
+	vst2q_f32(p, v);
+}
+
+inline void
+load3(const float* p, float4& a, float4& b, float4& c)
+{
+	float32x4x3_t v = vld3q_f32(p);
+	a = v.val[0];
+	b = v.val[1];
+	c = v.val[2];
+}
+
+inline void
+store3(float* p, float4 a, float4 b, float4 c)
+{
+	float32x4x3_t v;
+	v.val[0] = a;
+	v.val[1] = b;
+	v.val[2] = c;
+	vst3q_f32(p, v);
+}
+
+#else
+
+typedef __m128 float4;
+
+inline float4 set4(float a) { return _mm_set1_ps(a); }
+inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+inline float4 div4(float4 a, float4 b) { return _mm_div_ps(a, b); }
+inline float4 sqrt4(float4 a) { return _mm_sqrt_ps(a); }
+
+inline void
+load2(const float* p, float4& a, float4& b)
+{
+	float4 lo = _mm_loadu_ps(p);
+	float4 hi = _mm_loadu_ps(p + 4);
+	a = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+	b = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+inline void
+store2(float* p, float4 a, float4 b)
+{
+	_mm_storeu_ps(p, _mm_unpacklo_ps(a, b));
+	_mm_storeu_ps(p + 4, _mm_unpackhi_ps(a, b));
+}
+
+// SSE2 has no strided loads, three components are gathered by hand
+inline void
+load3(const float* p, float4& a, float4& b, float4& c)
+{
+	a = _mm_setr_ps(p[0], p[3], p[6], p[9]);
+	b = _mm_setr_ps(p[1], p[4], p[7], p[10]);
+	c = _mm_setr_ps(p[2], p[5], p[8], p[11]);
+}
+
+inline void
+store3(float* p, float4 a, float4 b, float4 c)
+{
+	float t[12];
+	_mm_storeu_ps(t, a);
+	_mm_storeu_ps(t + 4, b);
+	_mm_storeu_ps(t + 8, c);
+	for (int i = 0; i < 4; ++i)
+	{
+		p[3 * i] = t[i];
+		p[3 * i + 1] = t[4 + i];
+		p[3 * i + 2] = t[8 + i];
+	}
+}
+
+#endif
+
+struct Coefficients4
+{
+	float4 xi, oneMinusXi2, k1, k2, p1, p2;
+	float4 gamma1, gamma2, invGamma1, invGamma2, u0, v0;
+	float4 one, two;
+
+	explicit Coefficients4(const CataCameraParameters& params)
+	 : xi(set4(params.xi()))
+	 , oneMinusXi2(set4(1.0 - params.xi() * params.xi()))
+	 , k1(set4(params.k1()))
+	 , k2(set4(params.k2()))
+	 , p1(set4(params.p1()))
+	 , p2(set4(params.p2()))
+	 , gamma1(set4(params.gamma1()))
+	 , gamma2(set4(params.gamma2()))
+	 , invGamma1(set4(1.0 / params.gamma1()))
+	 , invGamma2(set4(1.0 / params.gamma2()))
+	 , u0(set4(params.u0()))
+	 , v0(set4(params.v0()))
+	 , one(set4(1.0f))
+	 , two(set4(2.0f))
+	{
+	}
+};
+
+inline void
+distortion4(const Coefficients4& c, float4 x, float4 y, float4& dx, float4& dy)
+{
+	float4 x2 = mul4(x, x);
+	float4 y2 = mul4(y, y);
+	float4 xy2 = mul4(c.two, mul4(x, y));
+	float4 r2 = add4(x2, y2);
+	float4 radial = mul4(r2, add4(c.k1, mul4(c.k2, r2)));
+	dx = add4(add4(mul4(x, radial), mul4(c.p1, xy2)), mul4(c.p2, add4(r2, mul4(c.two, x2))));
+	dy = add4(add4(mul4(y, radial), mul4(c.p2, xy2)), mul4(c.p1, add4(r2, mul4(c.two, y2))));
+}
+
+inline void
+liftProjective4(const Coefficients4& c, float4 u, float4 v, float4& X, float4& Y, float4& Z)
+{
+	float4 mx_d = mul4(sub4(u, c.u0), c.invGamma1);
+	float4 my_d = mul4(sub4(v, c.v0), c.invGamma2);
+
+	float4 mx_u = mx_d, my_u = my_d, dx, dy;
+	for (int i = 0; i < CataCamera::UNDISTORT_ITERATIONS; ++i)
+	{
+		distortion4(c, mx_u, my_u, dx, dy);
+		mx_u = sub4(mx_d, dx);
+		my_u = sub4(my_d, dy);
+	}
+
+	float4 r2 = add4(mul4(mx_u, mx_u), mul4(my_u, my_u));
+	float4 lambda = div4(add4(c.xi, sqrt4(add4(c.one, mul4(c.oneMinusXi2, r2)))), add4(c.one, r2));
+	X = mul4(lambda, mx_u);
+	Y = mul4(lambda, my_u);
+	Z = sub4(lambda, c.xi);
+}
+
+inline void
+spaceToPlane4(const Coefficients4& c, float4 X, float4 Y, float4 Z, float4& u, float4& v)
+{
+	float4 norm = sqrt4(add4(add4(mul4(X, X), mul4(Y, Y)), mul4(Z, Z)));
+	float4 inv = div4(c.one, add4(Z, mul4(c.xi, norm)));
+	float4 mx_u = mul4(X, inv);
+	float4 my_u = mul4(Y, inv);
+
+	float4 dx, dy;
+	distortion4(c, mx_u, my_u, dx, dy);
+	u = add4(mul4(c.gamma1, add4(mx_u, dx)), c.u0);
+	v = add4(mul4(c.gamma2, add4(my_u, dy)), c.v0);
+}
+
+inline size_t
+liftProjectiveBatch(const CataCameraParameters& params, const float* uv, float* xyz, size_t n)
+{
+	Coefficients4 c(params);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		float4 u, v, X, Y, Z;
+		load2(uv + 2 * i, u, v);
+		liftProjective4(c, u, v, X, Y, Z);
+		store3(xyz + 3 * i, X, Y, Z);
+	}
+	return i;
+}
+
+inline size_t
+spaceToPlaneBatch(const CataCameraParameters& params, const float* xyz, float* uv, size_t n)
+{
+	Coefficients4 c(params);
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		float4 X, Y, Z, u, v;
+		load3(xyz + 3 * i, X, Y, Z);
+		spaceToPlane4(c, X, Y, Z, u, v);
+		store2(uv + 2 * i, u, v);
+	}
+	return i;
+}
+
+}
+
+#endif
+
+}
+
+#endif
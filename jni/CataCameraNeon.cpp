@@ -0,0 +1,25 @@
+#include "CataCameraKernels.h"
+
+namespace vcharge
+{
+
+#if defined(CATACAMERA_NEON_DISPATCH) && defined(__ARM_NEON__)
+
+// Built with NEON (.neon in Android.mk), CataCamera.cpp only calls these
+// after checking the CPU features.
+
+size_t
+liftProjectiveNeon(const CataCameraParameters& params, const float* uv, float* xyz, size_t n)
+{
+	return liftProjectiveBatch(params, uv, xyz, n);
+}
+
+size_t
+spaceToPlaneNeon(const CataCameraParameters& params, const float* xyz, float* uv, size_t n)
+{
+	return spaceToPlaneBatch(params, xyz, uv, n);
+}
+
+#endif
+
+}
@@ -1,5 +1,7 @@
 #include "Chessboard.h"
 
+#include <map>
+
 #include <opencv2/calib3d/calib3d.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 
@@ -10,18 +12,23 @@
 namespace vcharge
 {
 
+bool larger_area(const cv::Size& s1, const cv::Size& s2)
+{
+	return s1.area() > s2.area();
+}
+
 Chessboard::Chessboard(cv::Size boardSize, cv::Mat& image)
  : mBoardSize(boardSize)
  , mCornersFound(false)
+ , mPartialBoards(false)
 {
+	// the sketch is only built if getSketch() is called
 	if (image.channels() == 1)
 	{
-		cv::cvtColor(image, mSketch, CV_GRAY2BGR);
 		image.copyTo(mImage);
 	}
 	else
 	{
-		image.copyTo(mSketch);
 		cv::cvtColor(image, mImage, CV_BGR2GRAY);
 	}
 }
@@ -29,18 +36,49 @@ Chessboard::Chessboard(cv::Size boardSize, cv::Mat& image)
 void
 Chessboard::findCorners(bool useOpenCV)
 {
-	mCornersFound = findChessboardCorners(mImage, mBoardSize, mCorners,
-										  CV_CALIB_CB_ADAPTIVE_THRESH +
-										  CV_CALIB_CB_NORMALIZE_IMAGE +
-										  CV_CALIB_CB_FILTER_QUADS +
-										  CV_CALIB_CB_FAST_CHECK,
-										  useOpenCV);
+	findBoards(std::vector<cv::Size>(1, mBoardSize), 1, useOpenCV);
+}
+
+void
+Chessboard::findBoards(const std::vector<cv::Size>& boardSizes, size_t maxBoards,
+					   bool useOpenCV)
+{
+	const int flags = CV_CALIB_CB_ADAPTIVE_THRESH +
+					  CV_CALIB_CB_NORMALIZE_IMAGE +
+					  CV_CALIB_CB_FILTER_QUADS +
+					  CV_CALIB_CB_FAST_CHECK;
 
+	mBoards.clear();
+	if (useOpenCV)
+	{
+		// OpenCV finds a single board, so one of each size at most
+		for (size_t i = 0; i < boardSizes.size() && mBoards.size() < maxBoards; ++i)
+		{
+			ChessboardDetection board;
+			board.boardSize = boardSizes.at(i);
+			board.gridSize = board.boardSize;
+			board.gridOffset = cv::Point(0, 0);
+			if (cv::findChessboardCorners(mImage, board.boardSize, board.corners, flags))
+			{
+				mBoards.push_back(board);
+			}
+		}
+	}
+	else
+	{
+		findChessboardCornersImproved(mImage, boardSizes, maxBoards, mBoards, flags);
+	}
+
+	mCornersFound = !mBoards.empty();
 	if (mCornersFound)
 	{
-		// draw chessboard corners
-		cv::drawChessboardCorners(mSketch, mBoardSize, mCorners, mCornersFound);
+		mCorners = mBoards.front().corners;
 	}
+	else
+	{
+		mCorners.clear();
+	}
+	mSketch.release();
 }
 
 const std::vector<cv::Point2f>&
@@ -49,12 +87,24 @@ Chessboard::getCorners(void) const
 	return mCorners;
 }
 
+const std::vector<ChessboardDetection>&
+Chessboard::getBoards(void) const
+{
+	return mBoards;
+}
+
 bool
 Chessboard::cornersFound(void) const
 {
 	return mCornersFound;
 }
 
+void
+Chessboard::setPartialBoards(bool enable)
+{
+	mPartialBoards = enable;
+}
+
 const cv::Mat&
 Chessboard::getImage(void) const
 {
@@ -64,29 +114,50 @@ Chessboard::getImage(void) const
 const cv::Mat&
 Chessboard::getSketch(void) const
 {
+	if (mSketch.empty())
+	{
+		cv::cvtColor(mImage, mSketch, CV_GRAY2BGR);
+		Overlay overlay;
+		getOverlay(overlay);
+		overlay.draw(mSketch);
+	}
 	return mSketch;
 }
 
-bool
-Chessboard::findChessboardCorners(const cv::Mat& image,
-							      const cv::Size& patternSize,
-							      std::vector<cv::Point2f>& corners,
-							      int flags, bool useOpenCV)
+void
+Chessboard::getOverlay(Overlay& overlay) const
 {
-	if (useOpenCV)
+	// corners joined row by row, with the colours of cv::drawChessboardCorners
+	static const cv::Scalar colours[] =
 	{
-		return cv::findChessboardCorners(image, patternSize, corners, flags);
-	}
-	else
+		cv::Scalar(0, 0, 255), cv::Scalar(0, 128, 255), cv::Scalar(0, 200, 200),
+		cv::Scalar(0, 255, 0), cv::Scalar(200, 200, 0), cv::Scalar(255, 0, 0),
+		cv::Scalar(255, 0, 255)
+	};
+	const int nColours = sizeof(colours) / sizeof(colours[0]);
+
+	for (size_t b = 0; b < mBoards.size(); ++b)
 	{
-		return findChessboardCornersImproved(image, patternSize, corners, flags);
+		const std::vector<cv::Point2f>& corners = mBoards[b].corners;
+		const int width = mBoards[b].gridSize.width;
+
+		for (size_t i = 0; i < corners.size(); ++i)
+		{
+			const cv::Scalar& colour = colours[(i / width) % nColours];
+			overlay.addPoint(corners[i], colour, 4.0f);
+			if (i > 0)
+			{
+				overlay.addSegment(corners[i - 1], corners[i], colour, 1.0f);
+			}
+		}
 	}
 }
 
 bool
 Chessboard::findChessboardCornersImproved(const cv::Mat& image,
-										  const cv::Size& patternSize,
-										  std::vector<cv::Point2f>& corners,
+										  const std::vector<cv::Size>& patternSizes,
+										  size_t maxBoards,
+										  std::vector<ChessboardDetection>& boards,
 										  int flags)
 {
 	/************************************************************************************\
@@ -125,12 +196,21 @@ Chessboard::findChessboardCornersImproved(const cv::Mat& image,
 		return false;
 	}
 
-	if (patternSize.width < 2 || patternSize.height < 2)
+	// the sizes that can be found, largest first, so that a group larger
+	// than a small board is first tried as the large one
+	std::vector<cv::Size> sizes;
+	for (size_t i = 0; i < patternSizes.size(); ++i)
 	{
-		return false;
+		const cv::Size& patternSize = patternSizes.at(i);
+		if (patternSize.width >= 2 && patternSize.height >= 2 &&
+			patternSize.width <= 127 && patternSize.height <= 127)
+		{
+			sizes.push_back(patternSize);
+		}
 	}
+	std::sort(sizes.begin(), sizes.end(), larger_area);
 
-	if (patternSize.width > 127 || patternSize.height > 127)
+	if (sizes.empty() || maxBoards == 0)
 	{
 		return false;
 	}
@@ -159,7 +239,12 @@ Chessboard::findChessboardCornersImproved(const cv::Mat& image,
 
     if (flags & CV_CALIB_CB_FAST_CHECK)
     {
-        if (!checkChessboard(img, patternSize))
+    	bool plausible = false;
+    	for (size_t i = 0; i < sizes.size() && !plausible; ++i)
+    	{
+    		plausible = checkChessboard(img, sizes.at(i));
+    	}
+        if (!plausible)
         {
         	return false;
         }
@@ -173,14 +258,23 @@ Chessboard::findChessboardCornersImproved(const cv::Mat& image,
 	// max_dilations is reached.
 
 	int prevSqrSize = 0;
-	bool found = false;
 	std::vector<ChessboardCornerPtr> outputCorners;
+	std::vector< std::vector<ChessboardCornerPtr> > foundCorners;
+
+	// the largest partial board over all passes, only used if no complete
+	// one is found
+	std::vector<ChessboardCornerPtr> partialCorners;
+	cv::Size partialBoardSize, partialGridSize;
+	cv::Point partialGridOffset;
 
 	for (int k = 0; k < 6; ++k)
 	{
 		for (int dilations = minDilations; dilations <= maxDilations; ++dilations)
 		{
-			if (found)
+			// every board that the pass finding the first one finds; a
+			// partial board does not end the search, the later passes are
+			// the ones that usually recover the complete board
+			if (!foundCorners.empty())
 			{
 				break;
 			}
@@ -258,71 +352,184 @@ Chessboard::findChessboardCornersImproved(const cv::Mat& image,
 			// function "cleanFoundConnectedQuads" erases the surplus
 			// quadrangles by minimizing the convex hull of the remaining pattern.
 
-			for (int group_idx = 0; ; ++group_idx)
+			for (int group_idx = 0; foundCorners.size() < maxBoards; ++group_idx)
 			{
-				std::vector<ChessboardQuadPtr> quadGroup;
+				std::vector<ChessboardQuadPtr> foundGroup;
 
-				findConnectedQuads(quads, quadGroup, group_idx, dilations);
+				findConnectedQuads(quads, foundGroup, group_idx, dilations);
 
-				if (quadGroup.empty())
+				if (foundGroup.empty())
 				{
 					break;
 				}
 
-				cleanFoundConnectedQuads(quadGroup, patternSize);
+				// Each group is a board candidate of its own, tried with every
+				// pattern size until one validates. Cleaning and labelling
+				// change the quads, so with several sizes each is tried on a
+				// copy of the group as it was found.
+				for (size_t s = 0; s < sizes.size(); ++s)
+				{
+					const cv::Size& patternSize = sizes.at(s);
 
-				// The following function labels all corners of every quad
-				// with a row and column entry.
-				// "count" specifies the number of found quads in "quad_group"
-				// with group identifier "group_idx"
-				// The last parameter is set to "true", because this is the
-				// first function call and some initializations need to be
-				// made.
-				labelQuadGroup(quadGroup, patternSize, true);
+					std::vector<ChessboardQuadPtr> quadGroup;
+					if (sizes.size() == 1)
+					{
+						quadGroup = foundGroup;
+					}
+					else
+					{
+						copyQuadGroup(foundGroup, quadGroup);
+					}
 
-				found = checkQuadGroup(quadGroup, outputCorners, patternSize);
+					cleanFoundConnectedQuads(quadGroup, patternSize);
 
-				float sumDist = 0;
-				int total = 0;
+					// The following function labels all corners of every quad
+					// with a row and column entry.
+					// "count" specifies the number of found quads in "quad_group"
+					// with group identifier "group_idx"
+					// The last parameter is set to "true", because this is the
+					// first function call and some initializations need to be
+					// made.
+					labelQuadGroup(quadGroup, patternSize, true);
 
-				for (int i = 0; i < outputCorners.size(); ++i)
-				{
-					int ni = 0;
-					float avgi = outputCorners.at(i)->meanDist(ni);
-					sumDist += avgi * ni;
-					total += ni;
-				}
-				prevSqrSize = lround(sumDist / std::max(total, 1));
+					bool found = checkQuadGroup(quadGroup, outputCorners, patternSize);
 
-				// MARTIN's Code
-				// To save computational time, only proceed, if the number of
-				// found quads during this dilation run is larger than the
-				// largest previous found number
-				if (found && !checkBoardMonotony(outputCorners, patternSize))
-				{
-					found = false;
+					float sumDist = 0;
+					int total = 0;
+
+					for (int i = 0; i < outputCorners.size(); ++i)
+					{
+						int ni = 0;
+						float avgi = outputCorners.at(i)->meanDist(ni);
+						sumDist += avgi * ni;
+						total += ni;
+					}
+					prevSqrSize = lround(sumDist / std::max(total, 1));
+
+					// MARTIN's Code
+					// To save computational time, only proceed, if the number of
+					// found quads during this dilation run is larger than the
+					// largest previous found number
+					if (found && checkBoardMonotony(outputCorners, patternSize))
+					{
+						ChessboardDetection board;
+						board.boardSize = patternSize;
+						board.gridSize = patternSize;
+						board.gridOffset = cv::Point(0, 0);
+						boards.push_back(board);
+						foundCorners.push_back(outputCorners);
+						break;
+					}
+
+					std::vector<ChessboardCornerPtr> corners;
+					cv::Size gridSize;
+					cv::Point gridOffset;
+					if (mPartialBoards &&
+						findPartialBoard(quadGroup, patternSize, corners, gridSize, gridOffset) &&
+						gridSize.area() > partialGridSize.area() &&
+						checkBoardMonotony(corners, gridSize))
+					{
+						partialCorners = corners;
+						partialBoardSize = patternSize;
+						partialGridSize = gridSize;
+						partialGridOffset = gridOffset;
+					}
 				}
 			}
 		}
 	}
 
-	if (!found)
+	if (foundCorners.empty() && !partialCorners.empty())
 	{
-		return false;
+		ChessboardDetection board;
+		board.boardSize = partialBoardSize;
+		board.gridSize = partialGridSize;
+		board.gridOffset = partialGridOffset;
+		boards.push_back(board);
+		foundCorners.push_back(partialCorners);
 	}
-	else
+
+	for (size_t b = 0; b < foundCorners.size(); ++b)
 	{
-		corners.clear();
-		corners.reserve(outputCorners.size());
-		for (size_t i = 0; i < outputCorners.size(); ++i)
+		std::vector<cv::Point2f>& corners = boards.at(boards.size() - foundCorners.size() + b).corners;
+		corners.reserve(foundCorners[b].size());
+		for (size_t i = 0; i < foundCorners[b].size(); ++i)
 		{
-			corners.push_back(outputCorners.at(i)->pt);
+			corners.push_back(foundCorners[b].at(i)->pt);
 		}
 
 		cv::cornerSubPix(image, corners, cv::Size(11, 11), cv::Size(-1,-1),
 						 cv::TermCriteria(CV_TERMCRIT_EPS + CV_TERMCRIT_ITER, 30, 0.1));
+	}
 
-		return true;
+	return !foundCorners.empty();
+}
+
+void
+Chessboard::copyQuadGroup(const std::vector<ChessboardQuadPtr>& quadGroup,
+						  std::vector<ChessboardQuadPtr>& copy) const
+{
+	// new quads and corners, linked to each other as the originals are;
+	// corners shared by neighboring quads stay shared
+	std::map<ChessboardQuad*, ChessboardQuadPtr> quads;
+	std::map<ChessboardCorner*, ChessboardCornerPtr> corners;
+	copy.clear();
+	copy.reserve(quadGroup.size());
+	for (size_t i = 0; i < quadGroup.size(); ++i)
+	{
+		const ChessboardQuadPtr& q = quadGroup.at(i);
+		ChessboardQuadPtr& quad = quads[q.get()];
+		quad.reset(new ChessboardQuad(*q));
+		copy.push_back(quad);
+		for (int j = 0; j < 4; ++j)
+		{
+			ChessboardCornerPtr& corner = corners[q->corners[j].get()];
+			if (!corner.get())
+			{
+				corner.reset(new ChessboardCorner(*q->corners[j]));
+			}
+			quad->corners[j] = corner;
+		}
+	}
+
+	for (size_t i = 0; i < copy.size(); ++i)
+	{
+		ChessboardQuadPtr& quad = copy.at(i);
+		for (int j = 0; j < 4; ++j)
+		{
+			if (quad->neighbors[j].get())
+			{
+				std::map<ChessboardQuad*, ChessboardQuadPtr>::iterator it = quads.find(quad->neighbors[j].get());
+				if (it != quads.end())
+				{
+					quad->neighbors[j] = it->second;
+				}
+				else
+				{
+					quad->neighbors[j].reset();
+				}
+			}
+		}
+	}
+
+	for (std::map<ChessboardCorner*, ChessboardCornerPtr>::iterator c = corners.begin(); c != corners.end(); ++c)
+	{
+		ChessboardCornerPtr& corner = c->second;
+		for (int j = 0; j < 4; ++j)
+		{
+			if (corner->neighbors[j].get())
+			{
+				std::map<ChessboardCorner*, ChessboardCornerPtr>::iterator it = corners.find(corner->neighbors[j].get());
+				if (it != corners.end())
+				{
+					corner->neighbors[j] = it->second;
+				}
+				else
+				{
+					corner->neighbors[j].reset();
+				}
+			}
+		}
 	}
 }
 
@@ -1471,6 +1678,15 @@ Chessboard::checkQuadGroup(std::vector<ChessboardQuadPtr>& quads,
     	corners = outputCorners;
     }
 
+	orientCorners(corners, width, height);
+
+	return true;
+}
+
+void
+Chessboard::orientCorners(std::vector<ChessboardCornerPtr>& corners,
+						  int width, int height) const
+{
     // check if we need to revert the order in each row
 	cv::Point2f p0 = corners.at(0)->pt;
 	cv::Point2f p1 = corners.at(width-1)->pt;
@@ -1506,7 +1722,210 @@ Chessboard::checkQuadGroup(std::vector<ChessboardQuadPtr>& quads,
 
 		corners = outputCorners;
 	}
+}
+
+//===========================================================================
+// PARTIAL BOARD
+//===========================================================================
+bool
+insideImage(const cv::Point2f& p, const cv::Mat& image)
+{
+	return p.x >= 0.0f && p.y >= 0.0f && p.x < image.cols && p.y < image.rows;
+}
+
+// The largest block of labelled inner corners of a quad group that did not
+// make a complete board, if it spans a whole side of the board so that its
+// rows and columns are those of the board. The corners are row by row in
+// the same orientation as checkQuadGroup returns them, and gridOffset is
+// the column and row of the first one in the complete board.
+bool
+Chessboard::findPartialBoard(std::vector<ChessboardQuadPtr>& quadGroup,
+							 cv::Size patternSize,
+							 std::vector<ChessboardCornerPtr>& corners,
+							 cv::Size& gridSize, cv::Point& gridOffset) const
+{
+	int min_row	=  127;
+	int max_row	= -127;
+	int min_col	=  127;
+	int max_col	= -127;
+
+	for (size_t i = 0; i < quadGroup.size(); ++i)
+	{
+		ChessboardQuadPtr& q = quadGroup.at(i);
+		if (!q->labeled)
+		{
+			return false;
+		}
+
+		for (int j = 0; j < 4; ++j)
+		{
+			ChessboardCornerPtr& c = q->corners[j];
+			min_row = std::min(min_row, c->row);
+			max_row = std::max(max_row, c->row);
+			min_col = std::min(min_col, c->column);
+			max_col = std::max(max_col, c->column);
+		}
+	}
+
+	const int rows = max_row - min_row + 1;
+	const int cols = max_col - min_col + 1;
+	if (rows < 3 || cols < 3)
+	{
+		return false;
+	}
+
+	// An inner corner of the board is shared by two quads; more than two
+	// on one label means a linking error, as in checkQuadGroup
+	std::vector<int> count(rows * cols, 0);
+	std::vector<ChessboardCornerPtr> labelled(rows * cols);
+	for (size_t i = 0; i < quadGroup.size(); ++i)
+	{
+		ChessboardQuadPtr& q = quadGroup.at(i);
+		for (int j = 0; j < 4; ++j)
+		{
+			int k = (q->corners[j]->row - min_row) * cols + q->corners[j]->column - min_col;
+			if (++count[k] > 2)
+			{
+				return false;
+			}
+			labelled[k] = q->corners[j];
+		}
+	}
+
+	// run[k]: inner corners ending at k along its row
+	std::vector<int> run(rows * cols, 0);
+	for (int i = 0; i < rows; ++i)
+	{
+		for (int j = 0; j < cols; ++j)
+		{
+			int k = i * cols + j;
+			if (count[k] == 2)
+			{
+				run[k] = (j > 0 ? run[k - 1] : 0) + 1;
+			}
+		}
+	}
+
+	// Largest rectangle of inner corners, by its bottom right corner and
+	// height. One of its sides has to be a whole side of the board, either
+	// way round, and it has to cover at least half of the board.
+	const int W = patternSize.width;
+	const int H = patternSize.height;
+	int bestArea = 0;
+	int bestRow = 0, bestCol = 0, bestWidth = 0, bestHeight = 0;
+
+	for (int i = 0; i < rows; ++i)
+	{
+		for (int j = 0; j < cols; ++j)
+		{
+			int maxWidth = run[i * cols + j];
+			for (int h = 1; h <= i + 1 && maxWidth > 0; ++h)
+			{
+				maxWidth = std::min(maxWidth, run[(i - h + 1) * cols + j]);
+
+				int w = 0;
+				if (h == H) w = std::max(w, std::min(maxWidth, W));
+				if (h == W) w = std::max(w, std::min(maxWidth, H));
+				if (h <= H && W <= maxWidth) w = std::max(w, W);
+				if (h <= W && H <= maxWidth) w = std::max(w, H);
+
+				if (w >= 3 && h >= 3 && w * h > bestArea && w * h < W * H &&
+					2 * w * h >= W * H)
+				{
+					bestArea = w * h;
+					bestRow = i - h + 1;
+					bestCol = j - w + 1;
+					bestWidth = w;
+					bestHeight = h;
+				}
+			}
+		}
+	}
+
+	if (bestArea == 0)
+	{
+		return false;
+	}
+
+	corners.clear();
+	corners.reserve(bestArea);
+	for (int i = bestRow; i < bestRow + bestHeight; ++i)
+	{
+		for (int j = bestCol; j < bestCol + bestWidth; ++j)
+		{
+			corners.push_back(labelled[i * cols + j]);
+		}
+	}
+
+	// rows along the width of the board, as for a complete one
+	int width = bestWidth;
+	int height = bestHeight;
+	if (!((width == W && height <= H) || (height == H && width <= W)))
+	{
+		std::vector<ChessboardCornerPtr> outputCorners(corners.size());
+		for (int i = 0; i < width; ++i)
+		{
+			for (int j = 0; j < height; ++j)
+			{
+				outputCorners.at(i * height + j) = corners.at(j * width + i);
+			}
+		}
+		corners = outputCorners;
+		std::swap(width, height);
+	}
+
+	orientCorners(corners, width, height);
+
+	// The labels only say where the corners are relative to each other. The
+	// rows or columns that are missing are taken to be the ones cut off by
+	// the image border, which has to be on one side only: two squares beyond
+	// the last visible line the board goes on outside the image there, on
+	// the other side the board has ended and that is the background. A board
+	// hidden by something else, or cut on both sides, is ambiguous.
+	const bool rowsMissing = width == W;
+	const int n = rowsMissing ? width : height;
+	bool cutBefore = false;
+	bool cutAfter = false;
+	for (int k = 0; k < n; ++k)
+	{
+		cv::Point2f first, second, last, beforeLast;
+		if (rowsMissing)
+		{
+			first = corners.at(k)->pt;
+			second = corners.at(width + k)->pt;
+			last = corners.at((height - 1) * width + k)->pt;
+			beforeLast = corners.at((height - 2) * width + k)->pt;
+		}
+		else
+		{
+			first = corners.at(k * width)->pt;
+			second = corners.at(k * width + 1)->pt;
+			last = corners.at(k * width + width - 1)->pt;
+			beforeLast = corners.at(k * width + width - 2)->pt;
+		}
+		cutBefore = cutBefore || !insideImage(first + (first - second) * 2.0f, mImage);
+		cutAfter = cutAfter || !insideImage(last + (last - beforeLast) * 2.0f, mImage);
+	}
+
+	if (cutBefore == cutAfter)
+	{
+		return false;
+	}
+
+	gridOffset = cv::Point(0, 0);
+	if (cutBefore)
+	{
+		if (rowsMissing)
+		{
+			gridOffset.y = H - height;
+		}
+		else
+		{
+			gridOffset.x = W - width;
+		}
+	}
 
+	gridSize = cv::Size(width, height);
 	return true;
 }
 
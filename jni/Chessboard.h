@@ -4,33 +4,61 @@
 #include <opencv2/core/core.hpp>
 
 #include "ChessboardQuad.h"
+#include "Overlay.h"
 
 namespace vcharge
 {
 
+// one board found by Chessboard::findBoards, corners row by row as getCorners
+struct ChessboardDetection
+{
+	cv::Size boardSize;
+	cv::Size gridSize;					// of the corners, smaller than boardSize for a partial board
+	cv::Point gridOffset;				// column and row in the board of the first corner
+	std::vector<cv::Point2f> corners;
+};
+
 class Chessboard
 {
 public:
 	Chessboard(cv::Size boardSize, cv::Mat& image);
 
 	void findCorners(bool useOpenCV = false);
+	// every board of one of the given sizes, up to maxBoards, from the
+	// first thresholding pass that finds any; getCorners is the first
+	void findBoards(const std::vector<cv::Size>& boardSizes, size_t maxBoards,
+					bool useOpenCV = false);
 	const std::vector<cv::Point2f>& getCorners(void) const;
+	const std::vector<ChessboardDetection>& getBoards(void) const;
 	bool cornersFound(void) const;
 
+	// if no complete board is found, return the largest labelled subgrid of
+	// one that spans a whole side of the board, e.g. with a row cut off by
+	// the image border, with its place in the board
+	void setPartialBoards(bool enable);
+
 	const cv::Mat& getImage(void) const;
 	const cv::Mat& getSketch(void) const;
+	void getOverlay(Overlay& overlay) const;
 
 private:
-	bool findChessboardCorners(const cv::Mat& image,
-							   const cv::Size& patternSize,
-							   std::vector<cv::Point2f>& corners,
-							   int flags, bool useOpenCV);
-
 	bool findChessboardCornersImproved(const cv::Mat& image,
-									   const cv::Size& patternSize,
-									   std::vector<cv::Point2f>& corners,
+									   const std::vector<cv::Size>& patternSizes,
+									   size_t maxBoards,
+									   std::vector<ChessboardDetection>& boards,
 									   int flags);
 
+	void copyQuadGroup(const std::vector<ChessboardQuadPtr>& quadGroup,
+					   std::vector<ChessboardQuadPtr>& copy) const;
+
+	bool findPartialBoard(std::vector<ChessboardQuadPtr>& quadGroup,
+						  cv::Size patternSize,
+						  std::vector<ChessboardCornerPtr>& corners,
+						  cv::Size& gridSize, cv::Point& gridOffset) const;
+
+	void orientCorners(std::vector<ChessboardCornerPtr>& corners,
+					   int width, int height) const;
+
 	void cleanFoundConnectedQuads(std::vector<ChessboardQuadPtr>& quadGroup, cv::Size patternSize);
 
 	void findConnectedQuads(std::vector<ChessboardQuadPtr>& quads,
@@ -70,10 +98,12 @@ private:
 					  ChessboardQuadPtr& quad2, int corner2) const;
 
 	cv::Mat mImage;
-	cv::Mat mSketch;
+	mutable cv::Mat mSketch;
 	std::vector<cv::Point2f> mCorners;
+	std::vector<ChessboardDetection> mBoards;
 	cv::Size mBoardSize;
 	bool mCornersFound;
+	bool mPartialBoards;
 };
 
 }
@@ -0,0 +1,151 @@
+#include "FramePipeline.h"
+
+#include <algorithm>
+
+FramePipeline::FramePipeline(Handler handler, void * context)
+	: mHandler(handler), 
+	  mContext(context), 
+	  mRunning(false), 
+	  mStopping(false), 
+	  mSequence(0), 
+	  mEnqueued(0), 
+	  mDropped(0), 
+	  mProcessed(0), 
+	  mAccepted(0)
+{
+	sem_init(&mWake, 0, 0); 
+}
+
+FramePipeline::~FramePipeline()
+{
+	stop(); 
+	sem_destroy(&mWake); 
+}
+
+bool
+FramePipeline::start()
+{
+	if (mRunning) return true; 
+	mStopping = false; 
+	mRunning = pthread_create(&mThread, NULL, run, this) == 0; 
+	return mRunning; 
+}
+
+void
+FramePipeline::stop()
+{
+	if (!mRunning) return; 
+	// the worker processes the pending frame, if any, before it returns
+	mStopping = true; 
+	sem_post(&mWake); 
+	pthread_join(mThread, NULL); 
+	mRunning = false; 
+}
+
+bool
+FramePipeline::running() const
+{
+	return mRunning; 
+}
+
+bool
+FramePipeline::enqueue(const cv::Mat & image, const cv::Mat & output, int mode, const double sensor[3], int64 timestamp)
+{
+	if (!mRunning) return false; 
+
+	// copyTo() keeps the slot buffers once they have the frame size, so the
+	// preview thread does not allocate in steady state
+	PipelineFrame & frame = mFrames.back(); 
+	image.copyTo(frame.image); 
+	output.copyTo(frame.output); 
+	frame.nv21 = false; 
+	return publish(frame, mode, sensor, timestamp); 
+}
+
+bool
+FramePipeline::enqueueNV21(const cv::Mat & yuv, int mode, const double sensor[3], int64 timestamp)
+{
+	if (!mRunning) return false; 
+
+	// the colour conversion is left to the worker, the preview thread only
+	// copies the raw buffer
+	PipelineFrame & frame = mFrames.back(); 
+	yuv.copyTo(frame.image); 
+	frame.nv21 = true; 
+	return publish(frame, mode, sensor, timestamp); 
+}
+
+bool
+FramePipeline::publish(PipelineFrame & frame, int mode, const double sensor[3], int64 timestamp)
+{
+	frame.mode = mode; 
+	frame.sensor[0] = sensor[0]; 
+	frame.sensor[1] = sensor[1]; 
+	frame.sensor[2] = sensor[2]; 
+	frame.timestamp = timestamp; 
+	frame.sequence = mSequence++; 
+
+	__sync_fetch_and_add(&mEnqueued, 1); 
+	if (mFrames.publish()) __sync_fetch_and_add(&mDropped, 1); 
+	sem_post(&mWake); 
+	return true; 
+}
+
+bool
+FramePipeline::poll(cv::Mat & output, Overlay & overlay, bool & success)
+{
+	if (!mResults.acquire()) return false; 
+	const PipelineResult & result = mResults.front(); 
+	result.output.copyTo(output); 
+	overlay = result.overlay; 
+	success = result.success; 
+	return true; 
+}
+
+PipelineStats
+FramePipeline::getStats() const
+{
+	PipelineStats stats; 
+	stats.enqueued = mEnqueued; 
+	stats.dropped = mDropped; 
+	stats.processed = mProcessed; 
+	stats.accepted = mAccepted; 
+	return stats; 
+}
+
+void *
+FramePipeline::run(void * arg)
+{
+	static_cast<FramePipeline *>(arg)->loop(); 
+	return NULL; 
+}
+
+void
+FramePipeline::loop()
+{
+	// several posts may be pending for a single published frame when frames
+	// were dropped, the extra wake ups find nothing to acquire
+	while (true)
+	{
+		while (sem_wait(&mWake) != 0) {}
+		// read before acquiring, so that a frame published before stop() is
+		// still processed rather than dropped
+		bool stopping = mStopping; 
+		if (mFrames.acquire()) process(mFrames.front()); 
+		if (stopping) break; 
+	}
+}
+
+void
+FramePipeline::process(PipelineFrame & frame)
+{
+	PipelineResult & result = mResults.back(); 
+	result.success = mHandler(mContext, frame); 
+	result.sequence = frame.sequence; 
+	std::swap(result.output, frame.output); 
+	std::swap(result.overlay, frame.overlay); 
+
+	__sync_fetch_and_add(&mProcessed, 1); 
+	if (result.success) __sync_fetch_and_add(&mAccepted, 1); 
+	mResults.publish(); 
+}
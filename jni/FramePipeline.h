@@ -0,0 +1,128 @@
+#ifndef FRAMEPIPELINE_H
+#define FRAMEPIPELINE_H
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <opencv2/core/core.hpp>
+
+#include "Overlay.h"
+
+#define PIPELINE_MODE_CHESSBOARD 0
+#define PIPELINE_MODE_VANISHING_POINT 1
+
+// Single producer, single consumer exchange of the latest value. The producer
+// fills back() and publishes it, the consumer acquires and reads front(); the
+// third slot sits in between, so neither side ever waits for the other. A
+// value published before the previous one was acquired replaces it.
+template <typename T>
+class TripleBuffer
+{
+	enum { INDEX = 3, FRESH = 4 }; 
+
+	T mSlots[3]; 
+	int mBack; 
+	int mFront; 
+	volatile int mMiddle; 
+
+public:
+	TripleBuffer() : mBack(0), mFront(1), mMiddle(2) {}
+
+	T & back() { return mSlots[mBack]; }
+	T & front() { return mSlots[mFront]; }
+	const T & front() const { return mSlots[mFront]; }
+
+	// returns true if an unread value was dropped
+	bool publish()
+	{
+		__sync_synchronize(); 
+		int previous = __sync_lock_test_and_set(&mMiddle, mBack | FRESH); 
+		mBack = previous & INDEX; 
+		return (previous & FRESH) != 0; 
+	}
+
+	// returns false if nothing was published since the last call
+	bool acquire()
+	{
+		if (!(mMiddle & FRESH)) return false; 
+		int previous = __sync_lock_test_and_set(&mMiddle, mFront); 
+		mFront = previous & INDEX; 
+		__sync_synchronize(); 
+		return true; 
+	}
+}; 
+
+struct PipelineFrame
+{
+	cv::Mat image;						// gray input, or the whole NV21 buffer
+	cv::Mat output;						// rgba image the detections are drawn on
+	bool nv21;							// output is converted from image by the handler
+	Overlay overlay;					// detections, filled by the handler
+	int mode;							// PIPELINE_MODE_*
+	double sensor[3];					// imu reading associated to the frame
+	int64 timestamp;					// exposure time for an imu lookup, or -1
+	size_t sequence; 
+}; 
+
+struct PipelineResult
+{
+	cv::Mat output; 
+	Overlay overlay; 
+	bool success; 
+	size_t sequence; 
+}; 
+
+struct PipelineStats
+{
+	PipelineStats() : enqueued(0), dropped(0), processed(0), accepted(0) {}
+
+	size_t enqueued; 
+	size_t dropped;						// replaced before the worker took them
+	size_t processed; 
+	size_t accepted; 
+}; 
+
+// Runs frame detection on a worker thread so that the camera preview thread
+// only has to copy the frame in. Frames are handed over through a triple
+// buffer with a latest-frame-wins policy: when the worker is busy, a newer
+// frame replaces the pending one. Results are handed back the same way and
+// polled by the caller.
+class FramePipeline
+{
+public:
+	typedef bool (*Handler)(void * context, PipelineFrame & frame); 
+
+	FramePipeline(Handler handler, void * context); 
+	~FramePipeline(); 
+
+	bool start(); 
+	void stop(); 
+	bool running() const; 
+
+	bool enqueue(const cv::Mat & image, const cv::Mat & output, int mode, const double sensor[3], int64 timestamp = -1); 
+	bool enqueueNV21(const cv::Mat & yuv, int mode, const double sensor[3], int64 timestamp = -1); 
+	bool poll(cv::Mat & output, Overlay & overlay, bool & success); 
+
+	PipelineStats getStats() const; 
+
+private:
+	static void * run(void * arg); 
+	void loop(); 
+	void process(PipelineFrame & frame); 
+	bool publish(PipelineFrame & frame, int mode, const double sensor[3], int64 timestamp); 
+
+	Handler mHandler; 
+	void * mContext; 
+
+	TripleBuffer<PipelineFrame> mFrames; 
+	TripleBuffer<PipelineResult> mResults; 
+
+	pthread_t mThread; 
+	sem_t mWake; 
+	volatile bool mRunning; 
+	volatile bool mStopping; 
+	size_t mSequence; 
+
+	volatile size_t mEnqueued, mDropped, mProcessed, mAccepted; 
+}; 
+
+#endif
@@ -0,0 +1,141 @@
+#include "FrameRecorder.h"
+
+#include <cstring>
+
+namespace
+{
+
+const uint32_t FRAME_FILE_VERSION = 1; 
+
+}
+
+FrameRecorder::FrameRecorder()
+	: mFile(NULL)
+{
+	memset(&mHeader, 0, sizeof(mHeader)); 
+}
+
+FrameRecorder::~FrameRecorder()
+{
+	close(); 
+}
+
+bool
+FrameRecorder::open(const char * path, cv::Size imageSize, cv::Size boardSize, bool gravity)
+{
+	close(); 
+	if (!path) return false; 
+
+	memset(&mHeader, 0, sizeof(mHeader)); 
+	memcpy(mHeader.magic, "MCFR", 4); 
+	mHeader.version = FRAME_FILE_VERSION; 
+	mHeader.width = imageSize.width; 
+	mHeader.height = imageSize.height; 
+	mHeader.boardWidth = boardSize.width; 
+	mHeader.boardHeight = boardSize.height; 
+	// padded, so that every record header is 8 byte aligned in the mapping
+	mHeader.recordSize = (sizeof(FrameRecordHeader) + imageSize.area() + 7) & ~7u; 
+	mHeader.flags = gravity ? FRAME_FILE_GRAVITY : 0; 
+
+	mFile = fopen(path, "wb"); 
+	if (!mFile) return false; 
+	if (fwrite(&mHeader, sizeof(mHeader), 1, mFile) != 1)
+	{
+		close(); 
+		return false; 
+	}
+	return true; 
+}
+
+void
+FrameRecorder::close()
+{
+	if (mFile) fclose(mFile); 
+	mFile = NULL; 
+}
+
+bool
+FrameRecorder::isOpen() const
+{
+	return mFile != NULL; 
+}
+
+bool
+FrameRecorder::write(int64_t timestamp, int mode, const double sensor[3], const uchar * gray)
+{
+	static const char zeros[8] = { 0 }; 
+	if (!mFile) return false; 
+
+	FrameRecordHeader record; 
+	memset(&record, 0, sizeof(record)); 
+	record.timestamp = timestamp; 
+	record.mode = mode; 
+	for (int i = 0; i < 3; i++)
+		record.sensor[i] = sensor[i]; 
+
+	size_t pixels = (size_t)mHeader.width * mHeader.height; 
+	size_t padding = mHeader.recordSize - sizeof(record) - pixels; 
+	return fwrite(&record, sizeof(record), 1, mFile) == 1
+		&& fwrite(gray, pixels, 1, mFile) == 1
+		&& (padding == 0 || fwrite(zeros, padding, 1, mFile) == 1); 
+}
+
+FramePlayback::FramePlayback()
+	: mFrames(0)
+{
+}
+
+bool
+FramePlayback::open(const char * path)
+{
+	mFrames = 0; 
+	if (!mFile.open(path)) return false; 
+
+	const FrameFileHeader * header = reinterpret_cast<const FrameFileHeader *>(mFile.data()); 
+	if (mFile.size() < sizeof(FrameFileHeader) || memcmp(header->magic, "MCFR", 4) != 0 
+		|| header->version != FRAME_FILE_VERSION 
+		|| header->recordSize < sizeof(FrameRecordHeader) + (size_t)header->width * header->height)
+	{
+		mFile.close(); 
+		return false; 
+	}
+
+	// a recording cut short ends with a partial record, which is left out
+	mFrames = (mFile.size() - sizeof(FrameFileHeader)) / header->recordSize; 
+	return true; 
+}
+
+void
+FramePlayback::close()
+{
+	mFile.close(); 
+	mFrames = 0; 
+}
+
+const FrameFileHeader &
+FramePlayback::getHeader() const
+{
+	return *reinterpret_cast<const FrameFileHeader *>(mFile.data()); 
+}
+
+size_t
+FramePlayback::getNumberOfFrames() const
+{
+	return mFrames; 
+}
+
+bool
+FramePlayback::getFrame(size_t index, PlaybackFrame & frame) const
+{
+	if (index >= mFrames) return false; 
+
+	const FrameFileHeader & header = getHeader(); 
+	const char * data = mFile.data() + sizeof(FrameFileHeader) + index * header.recordSize; 
+	const FrameRecordHeader * record = reinterpret_cast<const FrameRecordHeader *>(data); 
+	frame.timestamp = record->timestamp; 
+	frame.mode = record->mode; 
+	for (int i = 0; i < 3; i++)
+		frame.sensor[i] = record->sensor[i]; 
+	frame.image = cv::Mat(header.height, header.width, CV_8UC1, const_cast<char *>(data + sizeof(FrameRecordHeader))); 
+	return true; 
+}
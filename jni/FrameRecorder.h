@@ -0,0 +1,78 @@
+#ifndef FRAMERECORDER_H
+#define FRAMERECORDER_H
+
+#include <cstdio>
+#include <stdint.h>
+#include <opencv2/core/core.hpp>
+
+#include "MappedFile.h"
+
+#define FRAME_FILE_GRAVITY 1			// sensor readings are gravity vectors, not quaternions
+
+// Layout of a frame recording: the header, then records of recordSize bytes,
+// so frame i is at sizeof(FrameFileHeader) + i * recordSize. A record is the
+// FrameRecordHeader followed by the width x height gray (Y plane) pixels.
+struct FrameFileHeader
+{
+	char magic[4];						// "MCFR"
+	uint32_t version; 
+	int32_t width, height; 
+	int32_t boardWidth, boardHeight; 
+	uint32_t recordSize; 
+	uint32_t flags; 
+}; 
+
+struct FrameRecordHeader
+{
+	int64_t timestamp;					// nanoseconds, on the sensor event clock
+	int32_t mode;						// PIPELINE_MODE_*
+	int32_t reserved; 
+	double sensor[3];					// the imu reading paired with the frame
+}; 
+
+struct PlaybackFrame
+{
+	int64_t timestamp; 
+	int mode; 
+	double sensor[3]; 
+	cv::Mat image;						// points into the mapping, read-only
+}; 
+
+// Writes preview frames as they come; the file is only flushed when closed.
+class FrameRecorder
+{
+	FILE * mFile; 
+	FrameFileHeader mHeader; 
+
+	FrameRecorder(const FrameRecorder &); 
+	FrameRecorder & operator=(const FrameRecorder &); 
+
+public: 
+	FrameRecorder(); 
+	~FrameRecorder(); 
+
+	bool open(const char * path, cv::Size imageSize, cv::Size boardSize, bool gravity); 
+	void close(); 
+	bool isOpen() const; 
+
+	bool write(int64_t timestamp, int mode, const double sensor[3], const uchar * gray); 
+}; 
+
+// Random access to the frames of a recording, without copying the pixels.
+class FramePlayback
+{
+	MappedFile mFile; 
+	size_t mFrames; 
+
+public: 
+	FramePlayback(); 
+
+	bool open(const char * path); 
+	void close(); 
+
+	const FrameFileHeader & getHeader() const; 
+	size_t getNumberOfFrames() const; 
+	bool getFrame(size_t index, PlaybackFrame & frame) const; 
+}; 
+
+#endif
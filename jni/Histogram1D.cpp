@@ -0,0 +1,129 @@
+#include "Histogram1D.h"
+
+#include <cmath>
+#include <algorithm>
+
+Histogram1D::Histogram1D(float lower, float upper, int bins, bool circular)
+	: mLower(lower), 
+	  mUpper(upper), 
+	  mBins(bins), 
+	  mCircular(circular), 
+	  mVotes(bins, 0.0f), 
+	  mHead(bins, -1), 
+	  mData(NULL)
+{
+}
+
+int
+Histogram1D::binIndex(float value) const
+{
+	double a = mBins / ((double)mUpper - mLower); 
+	double b = -mLower * a; 
+	int idx = (int)floor(value * a + b); 
+	return (unsigned)idx < (unsigned)mBins ? idx : -1; 
+}
+
+int
+Histogram1D::vote(const std::vector<float> & data, bool smooth)
+{
+	return vote(data.empty() ? NULL : &data[0], data.size(), smooth); 
+}
+
+int
+Histogram1D::vote(const float * data, size_t n, bool smooth)
+{
+	std::fill(mVotes.begin(), mVotes.end(), 0.0f); 
+	std::fill(mHead.begin(), mHead.end(), -1); 
+	mNext.resize(n); 
+	mData = data; 
+
+	// single pass: bin, count and chain every sample into its bin
+	for (size_t i = 0; i < n; i++)
+	{
+		int idx = binIndex(data[i]); 
+		if (idx >= 0) mVotes[idx] += 1.0f; 
+		else idx = data[i] < mLower ? 0 : mBins - 1; 
+
+		// samples outside the range do not vote but may still support
+		mNext[i] = mHead[idx]; 
+		mHead[idx] = i; 
+	}
+
+	if (smooth) smoothVotes(); 
+
+	// first maximum, as cv::minMaxLoc
+	int best = 0; 
+	for (int i = 1; i < mBins; i++)
+		if (mVotes[i] > mVotes[best]) best = i; 
+	return best; 
+}
+
+void
+Histogram1D::smoothVotes()
+{
+	// [1 2 1] / 4 kernel, wrapping around for circular quantities
+	std::vector<float> votes(mVotes); 
+	for (int i = 0; i < mBins; i++)
+	{
+		int l = i - 1, r = i + 1; 
+		if (mCircular)
+		{
+			l = (l + mBins) % mBins; 
+			r = r % mBins; 
+		}
+		float vl = l >= 0 ? votes[l] : 0.0f; 
+		float vr = r < mBins ? votes[r] : 0.0f; 
+		mVotes[i] = 0.25f * vl + 0.5f * votes[i] + 0.25f * vr; 
+	}
+}
+
+float
+Histogram1D::binLower(int bin) const
+{
+	return mLower + bin * (mUpper - mLower) / mBins; 
+}
+
+float
+Histogram1D::binCenter(int bin) const
+{
+	return mLower + (0.5 + bin) * (mUpper - mLower) / mBins; 
+}
+
+float
+Histogram1D::binWidth() const
+{
+	return (mUpper - mLower) / mBins; 
+}
+
+float
+Histogram1D::getVotes(int bin) const
+{
+	return mVotes[bin]; 
+}
+
+void
+Histogram1D::support(float value, float threshold, std::vector<size_t> & index) const
+{
+	// only the bins within the threshold can hold supporting samples
+	float period = mUpper - mLower; 
+	int reach = (int)ceil(threshold / binWidth()) + 1; 
+	int center = (int)floor((value - mLower) / binWidth()); 
+	size_t first = index.size(); 
+
+	for (int k = center - reach; k <= center + reach; k++)
+	{
+		int bin = k; 
+		if (mCircular) bin = ((bin % mBins) + mBins) % mBins; 
+		else if (bin < 0 || bin >= mBins) continue; 
+		// with a small number of bins the window may wrap onto itself
+		if (mCircular && k - (center - reach) >= mBins) break; 
+
+		for (int i = mHead[bin]; i >= 0; i = mNext[i])
+		{
+			float d = fabs(mData[i] - value); 
+			if (d < threshold || (mCircular && period - d < threshold))
+				index.push_back(i); 
+		}
+	}
+	std::sort(index.begin() + first, index.end()); 
+}
@@ -0,0 +1,41 @@
+#ifndef HISTOGRAM1D_H
+#define HISTOGRAM1D_H
+
+#include <vector>
+#include <cstddef>
+
+// Uniform 1-D voting histogram over [lower, upper). vote() bins the data and
+// remembers which samples fell in which bin, so that the arg max and the
+// samples supporting it are available without rescanning the data. Binning
+// and tie-breaking follow cv::calcHist / cv::minMaxLoc.
+class Histogram1D
+{
+	float mLower; 
+	float mUpper; 
+	int mBins; 
+	bool mCircular; 
+
+	std::vector<float> mVotes; 
+	std::vector<int> mHead; 
+	std::vector<int> mNext; 
+	const float * mData; 
+
+public: 
+	Histogram1D(float lower, float upper, int bins, bool circular = false); 
+
+	int vote(const float * data, size_t n, bool smooth = false); 
+	int vote(const std::vector<float> & data, bool smooth = false); 
+
+	float binLower(int bin) const; 
+	float binCenter(int bin) const; 
+	float binWidth() const; 
+	float getVotes(int bin) const; 
+
+	void support(float value, float threshold, std::vector<size_t> & index) const; 
+
+protected:
+	int binIndex(float value) const; 
+	void smoothVotes(); 
+}; 
+
+#endif
@@ -0,0 +1,39 @@
+#include "IMUHistory.h"
+
+#include "Log.h"
+
+IMUHistory::IMUHistory(bool gravity)
+	: mGravity(gravity), 
+	  mTimeConstant(0.0)
+{
+}
+
+void
+IMUHistory::push(int64 timestamp, double x, double y, double z)
+{
+	mSamples.push(timestamp, x, y, z); 
+}
+
+void
+IMUHistory::setTimeConstant(double seconds)
+{
+	mTimeConstant = seconds; 
+}
+
+bool
+IMUHistory::lookup(int64 timestamp, double p[3]) const
+{
+	bool found = mGravity ? mSamples.lowPass(timestamp, mTimeConstant, p) : mSamples.slerp(timestamp, p); 
+	if (!found)
+	{
+		// usually the frame and sensor clocks disagree, the caller falls
+		// back to the reading it has
+		int64 oldest, newest; 
+		if (mSamples.range(oldest, newest))
+			LOGW("IMUHistory", "no imu samples around %lld, buffer covers %lld to %lld", 
+				 (long long)timestamp, (long long)oldest, (long long)newest); 
+		else
+			LOGW("IMUHistory", "no imu samples around %lld, buffer empty", (long long)timestamp); 
+	}
+	return found; 
+}
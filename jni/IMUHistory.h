@@ -0,0 +1,26 @@
+#ifndef IMUHISTORY_H
+#define IMUHISTORY_H
+
+#include "IMURingBuffer.h"
+
+// The samples of the sensor the calibration runs on, gravity or rotation
+// vector, and how a frame time is turned into one reading of it: gravity is
+// low-passed, the rotation vector interpolated on the sphere.
+class IMUHistory
+{
+	IMURingBuffer mSamples; 
+	bool mGravity; 
+	double mTimeConstant;				// seconds, of the gravity low-pass
+
+public: 
+	explicit IMUHistory(bool gravity); 
+
+	void push(int64 timestamp, double x, double y, double z); 
+	void setTimeConstant(double seconds); 
+
+	// the reading at the given time on the sensor clock, false and logged
+	// if the samples held do not cover it
+	bool lookup(int64 timestamp, double p[3]) const; 
+}; 
+
+#endif
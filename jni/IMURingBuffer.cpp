@@ -0,0 +1,203 @@
+#include "IMURingBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+
+IMURingBuffer::IMURingBuffer()
+	: mCount(0)
+{
+	for (size_t i = 0; i < CAPACITY; i++)
+		mSlots[i].index = -1; 
+}
+
+void
+IMURingBuffer::push(int64 timestamp, double x, double y, double z)
+{
+	int n = mCount; 
+	Slot & slot = mSlots[n & MASK]; 
+	slot.index = -1; 
+	__sync_synchronize(); 
+	slot.sample.timestamp = timestamp; 
+	slot.sample.v[0] = x; 
+	slot.sample.v[1] = y; 
+	slot.sample.v[2] = z; 
+	__sync_synchronize(); 
+	slot.index = n; 
+	__sync_synchronize(); 
+	mCount = n + 1; 
+}
+
+void
+IMURingBuffer::clear()
+{
+	// only safe from the writer's thread
+	for (size_t i = 0; i < CAPACITY; i++)
+		mSlots[i].index = -1; 
+	__sync_synchronize(); 
+	mCount = 0; 
+}
+
+bool
+IMURingBuffer::empty() const
+{
+	return mCount == 0; 
+}
+
+bool
+IMURingBuffer::range(int64 & oldest, int64 & newest) const
+{
+	int count = mCount; 
+	if (count == 0) return false; 
+	IMUSample first, last; 
+	if (!read(count > CAPACITY ? count - CAPACITY + 1 : 0, first) || !read(count - 1, last)) return false; 
+	oldest = first.timestamp; 
+	newest = last.timestamp; 
+	return true; 
+}
+
+bool
+IMURingBuffer::read(int index, IMUSample & sample) const
+{
+	const Slot & slot = mSlots[index & MASK]; 
+	if (slot.index != index) return false; 
+	__sync_synchronize(); 
+	sample = slot.sample; 
+	__sync_synchronize(); 
+	return slot.index == index; 
+}
+
+bool
+IMURingBuffer::bracket(int64 timestamp, IMUSample & before, IMUSample & after, int & index) const
+{
+	// binary search for the last sample not after the timestamp; samples
+	// overwritten during the search make it fail rather than return a wrong
+	// pair
+	int count = mCount; 
+	if (count == 0) return false; 
+	int lo = count > CAPACITY ? count - CAPACITY + 1 : 0; 
+	int hi = count - 1; 
+
+	IMUSample s; 
+	if (!read(lo, s) || s.timestamp > timestamp) return false; 
+	if (!read(hi, s)) return false; 
+	if (s.timestamp < timestamp)
+	{
+		if (timestamp - s.timestamp > MAX_HOLD) return false; 
+		index = hi; 
+		before = after = s; 
+		return true; 
+	}
+	while (hi - lo > 1)
+	{
+		int mid = lo + (hi - lo) / 2; 
+		if (!read(mid, s)) return false; 
+		if (s.timestamp <= timestamp) lo = mid; 
+		else hi = mid; 
+	}
+
+	index = lo; 
+	return read(lo, before) && read(hi, after); 
+}
+
+bool
+IMURingBuffer::interpolate(int64 timestamp, double v[3]) const
+{
+	IMUSample a, b; 
+	int index; 
+	if (!bracket(timestamp, a, b, index)) return false; 
+
+	double t = b.timestamp > a.timestamp ? double(timestamp - a.timestamp) / (b.timestamp - a.timestamp) : 0.0; 
+	for (size_t i = 0; i < 3; i++)
+		v[i] = (1.0 - t) * a.v[i] + t * b.v[i]; 
+	return true; 
+}
+
+bool
+IMURingBuffer::slerp(int64 timestamp, double q[3]) const
+{
+	IMUSample a, b; 
+	int index; 
+	if (!bracket(timestamp, a, b, index)) return false; 
+
+	double t = b.timestamp > a.timestamp ? double(timestamp - a.timestamp) / (b.timestamp - a.timestamp) : 0.0; 
+	double qa[4], qb[4]; 
+	for (size_t i = 0; i < 3; i++)
+	{
+		qa[i] = a.v[i]; 
+		qb[i] = b.v[i]; 
+	}
+	qa[3] = sqrt(std::max(0.0, 1.0 - qa[0] * qa[0] - qa[1] * qa[1] - qa[2] * qa[2])); 
+	qb[3] = sqrt(std::max(0.0, 1.0 - qb[0] * qb[0] - qb[1] * qb[1] - qb[2] * qb[2])); 
+
+	double d = qa[0] * qb[0] + qa[1] * qb[1] + qa[2] * qb[2] + qa[3] * qb[3]; 
+	if (d < 0)
+	{
+		for (size_t i = 0; i < 4; i++) qb[i] = -qb[i]; 
+		d = -d; 
+	}
+
+	// nearly identical rotations are interpolated linearly
+	double wa = 1.0 - t, wb = t; 
+	if (d < 0.9995)
+	{
+		double theta = acos(d); 
+		wa = sin((1.0 - t) * theta) / sin(theta); 
+		wb = sin(t * theta) / sin(theta); 
+	}
+
+	double r[4], norm = 0; 
+	for (size_t i = 0; i < 4; i++)
+	{
+		r[i] = wa * qa[i] + wb * qb[i]; 
+		norm += r[i] * r[i]; 
+	}
+	norm = sqrt(norm); 
+	if (norm < 1e-12) return false; 
+
+	// keep the scalar part positive, as the sensor reports it
+	double sign = r[3] < 0 ? -1.0 : 1.0; 
+	for (size_t i = 0; i < 3; i++)
+		q[i] = sign * r[i] / norm; 
+	return true; 
+}
+
+bool
+IMURingBuffer::lowPass(int64 timestamp, double timeConstant, double v[3]) const
+{
+	if (timeConstant <= 0) return interpolate(timestamp, v); 
+
+	IMUSample a, b; 
+	int index; 
+	if (!bracket(timestamp, a, b, index)) return false; 
+
+	// start five time constants back, or at the oldest sample still held
+	int64 window = int64(5.0 * timeConstant * 1e9); 
+	int first = index; 
+	IMUSample s; 
+	while (first > 0 && first > index - CAPACITY + 1)
+	{
+		if (!read(first - 1, s)) break; 
+		if (s.timestamp < timestamp - window) break; 
+		first--; 
+	}
+
+	if (!read(first, s)) return false; 
+	double g[3] = {s.v[0], s.v[1], s.v[2]}; 
+	int64 last = s.timestamp; 
+	for (int i = first + 1; i <= index; i++)
+	{
+		if (!read(i, s)) return false; 
+		double alpha = (s.timestamp - last) * 1e-9 / (timeConstant + (s.timestamp - last) * 1e-9); 
+		for (size_t k = 0; k < 3; k++)
+			g[k] += alpha * (s.v[k] - g[k]); 
+		last = s.timestamp; 
+	}
+
+	// last step up to the requested time, on the interpolated value
+	double end[3]; 
+	if (!interpolate(timestamp, end)) return false; 
+	double alpha = (timestamp - last) * 1e-9 / (timeConstant + (timestamp - last) * 1e-9); 
+	for (size_t k = 0; k < 3; k++)
+		v[k] = g[k] + alpha * (end[k] - g[k]); 
+	return true; 
+}
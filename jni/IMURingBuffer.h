@@ -0,0 +1,62 @@
+#ifndef IMURINGBUFFER_H
+#define IMURINGBUFFER_H
+
+#include <cstddef>
+#include <opencv2/core/core.hpp>
+
+struct IMUSample
+{
+	int64 timestamp;					// nanoseconds, as in SensorEvent.timestamp
+	double v[3]; 
+}; 
+
+// Timestamped sensor samples written by the sensor callback and read by the
+// detection, without locks. There is a single writer; every slot carries the
+// index of the sample it holds, set after the data, so that a reader detects
+// a slot being overwritten under it and gives up on that sample.
+class IMURingBuffer
+{
+	enum { CAPACITY = 1024, MASK = CAPACITY - 1 }; 
+
+	// a frame slightly newer than the last sample uses that sample rather
+	// than waiting for the next one
+	static const int64 MAX_HOLD = 20000000; 
+
+	struct Slot
+	{
+		volatile int index; 
+		IMUSample sample; 
+	}; 
+
+	Slot mSlots[CAPACITY]; 
+	volatile int mCount;				// int, so that it is read atomically on 32-bit ARM
+
+public: 
+	IMURingBuffer(); 
+
+	void push(int64 timestamp, double x, double y, double z); 
+	void clear(); 
+	bool empty() const; 
+	// timestamps of the oldest and newest samples held, false if empty
+	bool range(int64 & oldest, int64 & newest) const; 
+
+	// value at the given time, linearly interpolated between the samples
+	// around it; false if the time is not covered by the buffer, up to
+	// MAX_HOLD after the last sample
+	bool interpolate(int64 timestamp, double v[3]) const; 
+
+	// same for rotation vector samples (x, y, z of a unit quaternion with a
+	// positive scalar part), with spherical interpolation
+	bool slerp(int64 timestamp, double q[3]) const; 
+
+	// exponential low-pass with the given time constant in seconds over the
+	// samples up to the given time, which isolates gravity in accelerometer
+	// readings; falls back to interpolate() for a non-positive time constant
+	bool lowPass(int64 timestamp, double timeConstant, double v[3]) const; 
+
+protected:
+	bool read(int index, IMUSample & sample) const; 
+	bool bracket(int64 timestamp, IMUSample & before, IMUSample & after, int & index) const; 
+}; 
+
+#endif
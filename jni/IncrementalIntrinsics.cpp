@@ -0,0 +1,309 @@
+#include "IncrementalIntrinsics.h"
+
+#include <cmath>
+#include <opencv2/calib3d/calib3d.hpp>
+
+namespace
+{
+
+cv::Matx33d
+rotationFromVector(const cv::Vec3d & w)
+{
+	cv::Matx33d R; 
+	cv::Rodrigues(w, R); 
+	return R; 
+}
+
+}
+
+IncrementalIntrinsics::IncrementalIntrinsics(cv::Size imageSize, size_t window, int iterations)
+	: mEnabled(true), 
+	  mWindow(window), 
+	  mIterations(iterations)
+{
+	reset(imageSize); 
+}
+
+void
+IncrementalIntrinsics::reset(cv::Size imageSize)
+{
+	mImageSize = imageSize; 
+	mInitialized = false; 
+	mViews.clear(); 
+	mNumberOfViews = 0; 
+	mRMS = 0; 
+	mPriorInformation = cv::Matx66d::zeros(); 
+	mPriorVector = cv::Vec6d(); 
+}
+
+void
+IncrementalIntrinsics::setEnabled(bool enable)
+{
+	mEnabled = enable; 
+}
+
+bool
+IncrementalIntrinsics::addView(const std::vector<cv::Point3f> & objectPoints, const std::vector<cv::Point2f> & imagePoints)
+{
+	if (!mEnabled) return false; 
+	if (objectPoints.size() != imagePoints.size() || objectPoints.size() < 4) return false; 
+	if (!mInitialized) initialize(objectPoints, imagePoints); 
+
+	// the pose of the new view from the current intrinsics, as a starting
+	// point for the adjustment
+	View view; 
+	view.object = objectPoints; 
+	view.image = imagePoints; 
+	cv::Mat rvec, tvec; 
+	if (!cv::solvePnP(objectPoints, imagePoints, getCameraMatrix(), getDistortion(), rvec, tvec)) return false; 
+	view.R = rotationFromVector(cv::Vec3d(rvec)); 
+	view.t = cv::Vec3d(tvec); 
+
+	mViews.push_back(view); 
+	if (mViews.size() > mWindow)
+	{
+		marginalize(mViews.front()); 
+		mViews.pop_front(); 
+	}
+	mNumberOfViews++; 
+
+	optimize(); 
+	return true; 
+}
+
+bool
+IncrementalIntrinsics::available() const
+{
+	return mEnabled && mNumberOfViews >= 3; 
+}
+
+size_t
+IncrementalIntrinsics::getNumberOfViews() const
+{
+	return mNumberOfViews; 
+}
+
+double
+IncrementalIntrinsics::getRMS() const
+{
+	return mRMS; 
+}
+
+cv::Mat
+IncrementalIntrinsics::getCameraMatrix() const
+{
+	cv::Mat K = cv::Mat::eye(3, 3, CV_64F); 
+	K.at<double>(0, 0) = mIntrinsics[0]; 
+	K.at<double>(1, 1) = mIntrinsics[1]; 
+	K.at<double>(0, 2) = mIntrinsics[2]; 
+	K.at<double>(1, 2) = mIntrinsics[3]; 
+	return K; 
+}
+
+cv::Mat
+IncrementalIntrinsics::getDistortion() const
+{
+	cv::Mat d = cv::Mat::zeros(5, 1, CV_64F); 
+	d.at<double>(0) = mIntrinsics[4]; 
+	d.at<double>(1) = mIntrinsics[5]; 
+	return d; 
+}
+
+void
+IncrementalIntrinsics::initialize(const std::vector<cv::Point3f> & objectPoints, const std::vector<cv::Point2f> & imagePoints)
+{
+	// from the homography of the first view, unless it is too close to
+	// fronto-parallel for that, then a typical phone field of view
+	double w = mImageSize.width, h = mImageSize.height; 
+	mIntrinsics = cv::Vec6d(); 
+	mIntrinsics[0] = mIntrinsics[1] = w; 
+	mIntrinsics[2] = w / 2; 
+	mIntrinsics[3] = h / 2; 
+
+	cv::Mat K = cv::initCameraMatrix2D(std::vector<std::vector<cv::Point3f> >(1, objectPoints), 
+									   std::vector<std::vector<cv::Point2f> >(1, imagePoints), mImageSize); 
+	double f = K.at<double>(0, 0); 
+	if (f > 0.2 * w && f < 5 * w)
+		mIntrinsics[0] = mIntrinsics[1] = f; 
+
+	// weak prior around the starting point: focal within an image width,
+	// principal point within a quarter of it, distortion within 1
+	double sigma[6] = { w, w, w / 4, h / 4, 1, 1 }; 
+	for (int i = 0; i < 6; i++)
+	{
+		mPriorInformation(i, i) = 1 / (sigma[i] * sigma[i]); 
+		mPriorVector[i] = mPriorInformation(i, i) * mIntrinsics[i]; 
+	}
+	mInitialized = true; 
+}
+
+double
+IncrementalIntrinsics::accumulate(const View & view, const cv::Matx33d & R, const cv::Vec3d & t, 
+								  const cv::Vec6d & intrinsics, Blocks * blocks) const
+{
+	// sum of the squared reprojection errors of the view, and the normal
+	// equation blocks if requested; the rotation is perturbed on the left,
+	// R <- exp(w) R
+	const double fx = intrinsics[0], fy = intrinsics[1], cx = intrinsics[2], cy = intrinsics[3]; 
+	const double k1 = intrinsics[4], k2 = intrinsics[5]; 
+	if (blocks)
+	{
+		blocks->Hpp = blocks->Hpk = blocks->Hkk = cv::Matx66d::zeros(); 
+		blocks->bp = blocks->bk = cv::Vec6d(); 
+	}
+
+	double cost = 0; 
+	for (size_t j = 0; j < view.object.size(); j++)
+	{
+		cv::Vec3d X(view.object[j].x, view.object[j].y, view.object[j].z); 
+		cv::Vec3d RX = R * X; 
+		cv::Vec3d x = RX + t; 
+		if (x[2] <= 1e-9) continue; 
+
+		double u = x[0] / x[2], v = x[1] / x[2]; 
+		double r2 = u * u + v * v; 
+		double d = 1 + k1 * r2 + k2 * r2 * r2; 
+		cv::Vec2d e(fx * u * d + cx - view.image[j].x, fy * v * d + cy - view.image[j].y); 
+		cost += e.dot(e); 
+		if (!blocks) continue; 
+
+		// projection with respect to the normalized coordinates, then to x
+		double dd = 2 * k1 + 4 * k2 * r2; 
+		cv::Matx22d Juv(fx * (d + u * u * dd), fx * u * v * dd, 
+						fy * u * v * dd, fy * (d + v * v * dd)); 
+		cv::Matx<double, 2, 3> Jxuv(1 / x[2], 0, -x[0] / (x[2] * x[2]), 
+									0, 1 / x[2], -x[1] / (x[2] * x[2])); 
+		cv::Matx<double, 2, 3> Jx = Juv * Jxuv; 
+		cv::Matx33d skew(0, -RX[2], RX[1], 
+						 RX[2], 0, -RX[0], 
+						 -RX[1], RX[0], 0); 
+		cv::Matx<double, 2, 3> Jw = Jx * skew * -1.0; 
+
+		cv::Matx<double, 2, 6> Jp, Jk; 
+		for (int c = 0; c < 3; c++)
+		{
+			Jp(0, c) = Jw(0, c); 
+			Jp(1, c) = Jw(1, c); 
+			Jp(0, c + 3) = Jx(0, c); 
+			Jp(1, c + 3) = Jx(1, c); 
+		}
+		Jk = cv::Matx<double, 2, 6>::zeros(); 
+		Jk(0, 0) = u * d; 
+		Jk(0, 2) = 1; 
+		Jk(0, 4) = fx * u * r2; 
+		Jk(0, 5) = fx * u * r2 * r2; 
+		Jk(1, 1) = v * d; 
+		Jk(1, 3) = 1; 
+		Jk(1, 4) = fy * v * r2; 
+		Jk(1, 5) = fy * v * r2 * r2; 
+
+		blocks->Hpp += Jp.t() * Jp; 
+		blocks->Hpk += Jp.t() * Jk; 
+		blocks->Hkk += Jk.t() * Jk; 
+		blocks->bp -= cv::Vec6d(Jp.t() * e); 
+		blocks->bk -= cv::Vec6d(Jk.t() * e); 
+	}
+	return cost; 
+}
+
+double
+IncrementalIntrinsics::priorCost(const cv::Vec6d & intrinsics) const
+{
+	return 0.5 * intrinsics.dot(cv::Vec6d(mPriorInformation * intrinsics)) - mPriorVector.dot(intrinsics); 
+}
+
+void
+IncrementalIntrinsics::optimize()
+{
+	size_t n = mViews.size(); 
+	std::vector<Blocks> blocks(n); 
+	std::vector<cv::Matx66d> HppInv(n); 
+	double lambda = 1e-3; 
+
+	double cost = priorCost(mIntrinsics); 
+	for (size_t i = 0; i < n; i++)
+		cost += 0.5 * accumulate(mViews[i], mViews[i].R, mViews[i].t, mIntrinsics, &blocks[i]); 
+
+	for (int it = 0; it < mIterations; it++)
+	{
+		// reduced system in the intrinsics, S dk = r
+		cv::Matx66d S = mPriorInformation; 
+		cv::Vec6d r = mPriorVector - cv::Vec6d(mPriorInformation * mIntrinsics); 
+		for (size_t i = 0; i < n; i++)
+		{
+			S += blocks[i].Hkk; 
+			r += blocks[i].bk; 
+		}
+		for (int k = 0; k < 6; k++)
+			S(k, k) *= 1 + lambda; 
+		for (size_t i = 0; i < n; i++)
+		{
+			cv::Matx66d Hpp = blocks[i].Hpp; 
+			for (int k = 0; k < 6; k++)
+				Hpp(k, k) = Hpp(k, k) * (1 + lambda) + 1e-9; 
+			HppInv[i] = Hpp.inv(cv::DECOMP_CHOLESKY); 
+			cv::Matx66d HkpHppInv = blocks[i].Hpk.t() * HppInv[i]; 
+			S -= HkpHppInv * blocks[i].Hpk; 
+			r -= cv::Vec6d(HkpHppInv * blocks[i].bp); 
+		}
+		cv::Vec6d dk = S.solve(r, cv::DECOMP_CHOLESKY); 
+
+		// back-substitute the poses and keep the step if it lowers the cost
+		cv::Vec6d intrinsics = mIntrinsics + dk; 
+		std::vector<cv::Matx33d> Rs(n); 
+		std::vector<cv::Vec3d> ts(n); 
+		double newCost = priorCost(intrinsics); 
+		for (size_t i = 0; i < n; i++)
+		{
+			cv::Vec6d dp = HppInv[i] * cv::Vec6d(blocks[i].bp - cv::Vec6d(blocks[i].Hpk * dk)); 
+			Rs[i] = rotationFromVector(cv::Vec3d(dp[0], dp[1], dp[2])) * mViews[i].R; 
+			ts[i] = mViews[i].t + cv::Vec3d(dp[3], dp[4], dp[5]); 
+			newCost += 0.5 * accumulate(mViews[i], Rs[i], ts[i], intrinsics, NULL); 
+		}
+
+		if (newCost < cost)
+		{
+			mIntrinsics = intrinsics; 
+			for (size_t i = 0; i < n; i++)
+			{
+				mViews[i].R = Rs[i]; 
+				mViews[i].t = ts[i]; 
+			}
+			cost = newCost; 
+			lambda /= 10; 
+			if (it + 1 < mIterations)
+				for (size_t i = 0; i < n; i++)
+					accumulate(mViews[i], mViews[i].R, mViews[i].t, mIntrinsics, &blocks[i]); 
+		}
+		else
+			lambda *= 10; 
+	}
+
+	double squared = 0; 
+	size_t points = 0; 
+	for (size_t i = 0; i < n; i++)
+	{
+		squared += accumulate(mViews[i], mViews[i].R, mViews[i].t, mIntrinsics, NULL); 
+		points += mViews[i].object.size(); 
+	}
+	mRMS = points > 0 ? sqrt(squared / points) : 0; 
+}
+
+void
+IncrementalIntrinsics::marginalize(const View & view)
+{
+	// the view's information on the intrinsics, with its pose eliminated,
+	// linearized at the current estimate:
+	// 0.5 dk' S dk - g' dk, with dk = k - k0
+	Blocks blocks; 
+	accumulate(view, view.R, view.t, mIntrinsics, &blocks); 
+	cv::Matx66d Hpp = blocks.Hpp; 
+	for (int k = 0; k < 6; k++)
+		Hpp(k, k) += 1e-9; 
+	cv::Matx66d HkpHppInv = blocks.Hpk.t() * Hpp.inv(cv::DECOMP_CHOLESKY); 
+	cv::Matx66d S = blocks.Hkk - HkpHppInv * blocks.Hpk; 
+	cv::Vec6d g = blocks.bk - cv::Vec6d(HkpHppInv * blocks.bp); 
+
+	mPriorInformation += S; 
+	mPriorVector += g + cv::Vec6d(S * mIntrinsics); 
+}
@@ -0,0 +1,72 @@
+#ifndef INCREMENTALINTRINSICS_H
+#define INCREMENTALINTRINSICS_H
+
+#include <deque>
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+// Pinhole intrinsics with two radial distortion terms, refined as chessboard
+// views come in instead of in one batch at the end. The last few views and
+// the intrinsics are adjusted together by damped Gauss-Newton on the
+// reprojection error; the normal equations have one 6x6 block per view pose
+// and one for the shared intrinsics, so the poses are eliminated with the
+// Schur complement and only a 6x6 system is solved. A view leaving the window
+// is marginalized into a prior on the intrinsics, which keeps the cost of an
+// update the same however many views were added.
+class IncrementalIntrinsics
+{
+	struct View
+	{
+		std::vector<cv::Point3f> object; 
+		std::vector<cv::Point2f> image; 
+		cv::Matx33d R; 
+		cv::Vec3d t; 
+	}; 
+
+	struct Blocks
+	{
+		cv::Matx66d Hpp, Hpk, Hkk;		// pose (rotation, translation) and intrinsics
+		cv::Vec6d bp, bk; 
+	}; 
+
+	bool mEnabled; 
+	cv::Size mImageSize; 
+	size_t mWindow; 
+	int mIterations; 
+
+	cv::Vec6d mIntrinsics;				// fx, fy, cx, cy, k1, k2
+	bool mInitialized; 
+	std::deque<View> mViews; 
+	size_t mNumberOfViews; 
+	double mRMS; 
+
+	// prior on the intrinsics, 0.5 x' A x - b' x
+	cv::Matx66d mPriorInformation; 
+	cv::Vec6d mPriorVector; 
+
+public: 
+	IncrementalIntrinsics(cv::Size imageSize = cv::Size(), size_t window = 8, int iterations = 3); 
+
+	void reset(cv::Size imageSize); 
+	// on by default; while off, views are not added and nothing is available
+	void setEnabled(bool enable); 
+	bool addView(const std::vector<cv::Point3f> & objectPoints, const std::vector<cv::Point2f> & imagePoints); 
+
+	// once enough views constrain the intrinsics
+	bool available() const; 
+	size_t getNumberOfViews() const; 
+	double getRMS() const;				// over the views in the window, in pixels
+
+	cv::Mat getCameraMatrix() const; 
+	cv::Mat getDistortion() const;		// k1, k2, p1, p2, k3 as cv::calibrateCamera
+	
+protected: 
+	void initialize(const std::vector<cv::Point3f> & objectPoints, const std::vector<cv::Point2f> & imagePoints); 
+	double accumulate(const View & view, const cv::Matx33d & R, const cv::Vec3d & t, 
+					  const cv::Vec6d & intrinsics, Blocks * blocks) const; 
+	double priorCost(const cv::Vec6d & intrinsics) const; 
+	void optimize(); 
+	void marginalize(const View & view); 
+}; 
+
+#endif
@@ -0,0 +1,45 @@
+#include "IncrementalKabsch.h"
+
+IncrementalKabsch::IncrementalKabsch()
+	: mCovariance(cv::Matx33d::zeros()), 
+	  mSamples(0)
+{
+}
+
+void
+IncrementalKabsch::add(const cv::Vec3d & source, const cv::Vec3d & target)
+{
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 3; j++)
+			mCovariance(i, j) += target[i] * source[j]; 
+	mSamples++; 
+}
+
+void
+IncrementalKabsch::reset()
+{
+	mCovariance = cv::Matx33d::zeros(); 
+	mSamples = 0; 
+}
+
+size_t
+IncrementalKabsch::getNumberOfSamples() const
+{
+	return mSamples; 
+}
+
+bool
+IncrementalKabsch::getRotation(cv::Matx33d & R, double & conditioning, double minConditioning) const
+{
+	conditioning = 0; 
+	if (mSamples == 0) return false; 
+
+	cv::Mat D, U, Vt; 
+	cv::SVD::compute(cv::Mat(mCovariance), D, U, Vt); 
+	cv::Mat UVt = U * Vt; 
+	R = cv::Matx33d(UVt.ptr<double>()); 
+
+	if (D.at<double>(0) > 0)
+		conditioning = D.at<double>(1) / D.at<double>(0); 
+	return conditioning >= minConditioning; 
+}
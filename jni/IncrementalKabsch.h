@@ -0,0 +1,28 @@
+#ifndef INCREMENTALKABSCH_H
+#define INCREMENTALKABSCH_H
+
+#include <cstddef>
+#include <opencv2/core/core.hpp>
+
+// Rotation between two sets of directions, as in the Kabsch algorithm, from
+// the running 3x3 cross-covariance of the pairs. Adding a pair is O(1) and
+// the pairs themselves are not stored.
+class IncrementalKabsch
+{
+	cv::Matx33d mCovariance; 
+	size_t mSamples; 
+
+public: 
+	IncrementalKabsch(); 
+
+	void add(const cv::Vec3d & source, const cv::Vec3d & target); 
+	void reset(); 
+	size_t getNumberOfSamples() const; 
+
+	// R such that target ~ R * source, and the ratio of the two largest
+	// singular values of the covariance; a small ratio means the pairs are
+	// nearly all along one direction and R is not determined
+	bool getRotation(cv::Matx33d & R, double & conditioning, double minConditioning = 0.01) const; 
+}; 
+
+#endif
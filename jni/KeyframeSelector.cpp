@@ -0,0 +1,127 @@
+#include "KeyframeSelector.h"
+
+#include <algorithm>
+#include <cmath>
+
+KeyframeSelector::KeyframeSelector(cv::Size imageSize, float minCoverage, float minPoseDistance, double minGravityAngle)
+	: mEnabled(false), 
+	  mMinCoverage(minCoverage), 
+	  mMinPoseDistance(minPoseDistance), 
+	  mMinGravityCos(cos(minGravityAngle * CV_PI / 180.0))
+{
+	reset(imageSize); 
+}
+
+void
+KeyframeSelector::reset(cv::Size imageSize)
+{
+	mImageSize = imageSize; 
+	mCoverage.assign(GRID_COLS * GRID_ROWS, 0); 
+	mOutlines.clear(); 
+	mGravity.clear(); 
+	mStats = KeyframeStats(); 
+}
+
+void
+KeyframeSelector::setEnabled(bool enable)
+{
+	mEnabled = enable; 
+}
+
+bool
+KeyframeSelector::isEnabled() const
+{
+	return mEnabled; 
+}
+
+bool
+KeyframeSelector::select(const std::vector<cv::Point2f> & corners, cv::Size boardSize, const cv::Vec3d * gravity)
+{
+	if (!mEnabled) return true; 
+	mStats.considered++; 
+	if (corners.empty() || (int)corners.size() != boardSize.area()) return false; 
+
+	Outline outline; 
+	outline.corners[0] = corners[0]; 
+	outline.corners[1] = corners[boardSize.width - 1]; 
+	outline.corners[2] = corners[corners.size() - 1]; 
+	outline.corners[3] = corners[corners.size() - boardSize.width]; 
+
+	cv::Vec3d g; 
+	if (gravity) g = cv::normalize(*gravity); 
+
+	bool novel = mOutlines.empty()
+		|| coverageNovelty(corners) >= mMinCoverage
+		|| poseDistance(outline) >= mMinPoseDistance
+		|| (gravity && !mGravity.empty() && gravityNovel(g)); 
+	if (!novel) return false; 
+
+	for (size_t i = 0; i < corners.size(); i++)
+	{
+		int c = cell(corners[i]); 
+		if (c >= 0) mCoverage[c]++; 
+	}
+	mOutlines.push_back(outline); 
+	if (gravity) mGravity.push_back(g); 
+	mStats.accepted++; 
+	return true; 
+}
+
+const KeyframeStats &
+KeyframeSelector::getStats() const
+{
+	return mStats; 
+}
+
+int
+KeyframeSelector::cell(const cv::Point2f & pt) const
+{
+	if (mImageSize.width <= 0 || mImageSize.height <= 0) return -1; 
+	int col = (int)(pt.x * GRID_COLS / mImageSize.width); 
+	int row = (int)(pt.y * GRID_ROWS / mImageSize.height); 
+	if (col < 0 || col >= GRID_COLS || row < 0 || row >= GRID_ROWS) return -1; 
+	return row * GRID_COLS + col; 
+}
+
+float
+KeyframeSelector::coverageNovelty(const std::vector<cv::Point2f> & corners) const
+{
+	size_t uncovered = 0; 
+	for (size_t i = 0; i < corners.size(); i++)
+	{
+		int c = cell(corners[i]); 
+		if (c >= 0 && mCoverage[c] == 0) uncovered++; 
+	}
+	return (float)uncovered / corners.size(); 
+}
+
+float
+KeyframeSelector::poseDistance(const Outline & outline) const
+{
+	// the detection order of the corners can be reversed for the same board
+	// pose, so both orders are compared
+	float diagonal = sqrt((float)mImageSize.width * mImageSize.width + (float)mImageSize.height * mImageSize.height); 
+	float best = -1; 
+	for (size_t i = 0; i < mOutlines.size(); i++)
+	{
+		float direct = 0, reversed = 0; 
+		for (int k = 0; k < 4; k++)
+		{
+			cv::Point2f d = outline.corners[k] - mOutlines[i].corners[k]; 
+			cv::Point2f r = outline.corners[k] - mOutlines[i].corners[(k + 2) % 4]; 
+			direct += sqrt(d.x * d.x + d.y * d.y); 
+			reversed += sqrt(r.x * r.x + r.y * r.y); 
+		}
+		float distance = std::min(direct, reversed) / 4; 
+		if (best < 0 || distance < best) best = distance; 
+	}
+	return best < 0 ? 1.0f : best / std::max(diagonal, 1.0f); 
+}
+
+bool
+KeyframeSelector::gravityNovel(const cv::Vec3d & gravity) const
+{
+	for (size_t i = 0; i < mGravity.size(); i++)
+		if (gravity.dot(mGravity[i]) > mMinGravityCos) return false; 
+	return true; 
+}
@@ -0,0 +1,63 @@
+#ifndef KEYFRAMESELECTOR_H
+#define KEYFRAMESELECTOR_H
+
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+struct KeyframeStats
+{
+	KeyframeStats() : considered(0), accepted(0) {}
+
+	size_t rejected() const { return considered - accepted; }
+
+	size_t considered;					// detections submitted to select()
+	size_t accepted; 
+}; 
+
+// Keeps a chessboard view only if it adds something to the views kept so
+// far: corners in image cells no earlier view covered, a board pose away from
+// all the earlier ones, or a gravity direction away from all the earlier
+// ones. A phone held still then adds one view instead of one per frame.
+// Until it is enabled, every view is kept and none is counted.
+class KeyframeSelector
+{
+	enum { GRID_COLS = 8, GRID_ROWS = 6 }; 
+
+	struct Outline
+	{
+		cv::Point2f corners[4];			// the outer corners, in detection order
+	}; 
+
+	bool mEnabled; 
+	cv::Size mImageSize; 
+	float mMinCoverage;					// fraction of the corners in uncovered cells
+	float mMinPoseDistance;				// mean outer corner displacement, over the image diagonal
+	double mMinGravityCos; 
+
+	std::vector<int> mCoverage; 
+	std::vector<Outline> mOutlines; 
+	std::vector<cv::Vec3d> mGravity; 
+	KeyframeStats mStats; 
+
+public: 
+	KeyframeSelector(cv::Size imageSize = cv::Size(), float minCoverage = 0.1f, 
+					 float minPoseDistance = 0.05f, double minGravityAngle = 5.0); 
+
+	void reset(cv::Size imageSize); 
+	void setEnabled(bool enable); 
+	bool isEnabled() const; 
+
+	// true if the view is kept, in which case it is added to the kept set;
+	// gravity may be NULL when no imu reading is available for the view
+	bool select(const std::vector<cv::Point2f> & corners, cv::Size boardSize, const cv::Vec3d * gravity); 
+
+	const KeyframeStats & getStats() const; 
+
+protected: 
+	int cell(const cv::Point2f & pt) const; 
+	float coverageNovelty(const std::vector<cv::Point2f> & corners) const; 
+	float poseDistance(const Outline & outline) const; 
+	bool gravityNovel(const cv::Vec3d & gravity) const; 
+}; 
+
+#endif
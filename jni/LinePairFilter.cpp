@@ -0,0 +1,87 @@
+#include "LinePairFilter.h"
+
+#include <cmath>
+#include <algorithm>
+
+LinePairFilter::LinePairFilter(float minAngle, float collinearDistance)
+	: mMinAngle(minAngle), 
+	  mCollinearDistance(collinearDistance), 
+	  mLines(NULL)
+{
+	mBuckets = std::max(1, (int)floor(CV_PI / minAngle)); 
+}
+
+void
+LinePairFilter::setLines(const std::vector<cv::Vec4i> & lines)
+{
+	mLines = &lines; 
+	mAngles.resize(lines.size()); 
+	mBucket.resize(lines.size()); 
+	for (size_t i = 0; i < lines.size(); i++)
+	{
+		// orientation modulo pi
+		float angle = atan2((float)(lines[i][3] - lines[i][1]), (float)(lines[i][2] - lines[i][0])); 
+		if (angle < 0) angle += CV_PI; 
+		if (angle >= CV_PI) angle -= CV_PI; 
+		mAngles[i] = angle; 
+		mBucket[i] = std::min((int)(angle / CV_PI * mBuckets), mBuckets - 1); 
+	}
+}
+
+bool
+LinePairFilter::accept(size_t i, size_t j) const
+{
+	mStats.tested++; 
+
+	int db = abs(mBucket[i] - mBucket[j]); 
+	if (db > 1 && db < mBuckets - 1) return true; 
+
+	float d = fabs(mAngles[i] - mAngles[j]); 
+	d = std::min(d, (float)CV_PI - d); 
+	if (d >= mMinAngle) return true; 
+
+	if (collinear((*mLines)[i], (*mLines)[j])) mStats.collinear++; 
+	else mStats.parallel++; 
+	return false; 
+}
+
+bool
+LinePairFilter::samplePair(cv::RNG & rng, size_t & i, size_t & j, int maxDraws) const
+{
+	size_t n = mLines->size(); 
+	for (int draw = 0; draw < maxDraws; draw++)
+	{
+		i = rng(n); 
+		j = rng(n - 1); 
+		if (j >= i) j++; 
+		if (accept(i, j)) return true; 
+	}
+	return false; 
+}
+
+bool
+LinePairFilter::collinear(const cv::Vec4i & a, const cv::Vec4i & b) const
+{
+	// distance of b's midpoint to the line through a, and overlap of the
+	// projections of both segments onto a
+	float dx = a[2] - a[0]; 
+	float dy = a[3] - a[1]; 
+	float len = hypot(dx, dy); 
+	if (len == 0) return true; 
+	dx /= len; 
+	dy /= len; 
+
+	float mx = 0.5f * (b[0] + b[2]) - a[0]; 
+	float my = 0.5f * (b[1] + b[3]) - a[1]; 
+	if (fabs(mx * dy - my * dx) > mCollinearDistance) return false; 
+
+	float t0 = (b[0] - a[0]) * dx + (b[1] - a[1]) * dy; 
+	float t1 = (b[2] - a[0]) * dx + (b[3] - a[1]) * dy; 
+	return std::max(t0, t1) >= 0 && std::min(t0, t1) <= len; 
+}
+
+const LinePairStats &
+LinePairFilter::getStats() const
+{
+	return mStats; 
+}
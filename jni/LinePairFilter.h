@@ -0,0 +1,55 @@
+#ifndef LINEPAIRFILTER_H
+#define LINEPAIRFILTER_H
+
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+struct LinePairStats
+{
+	LinePairStats() : tested(0), parallel(0), collinear(0) {}
+
+	LinePairStats & operator+=(const LinePairStats & other)
+	{
+		tested += other.tested; 
+		parallel += other.parallel; 
+		collinear += other.collinear; 
+		return *this; 
+	}
+
+	size_t rejected() const { return parallel + collinear; }
+
+	size_t tested;						// pairs submitted to accept()
+	size_t parallel;					// rejected, angle below threshold
+	size_t collinear;					// rejected, overlapping on one line
+};
+
+// Rejects line pairs that cannot give a stable vanishing point before their
+// intersection is computed. Orientations are computed once per line and
+// bucketed with the bucket width at least the angle threshold, so pairs in
+// non-adjacent buckets are accepted without any further test.
+class LinePairFilter
+{
+	float mMinAngle; 
+	float mCollinearDistance; 
+	int mBuckets; 
+	const std::vector<cv::Vec4i> * mLines; 
+	std::vector<float> mAngles; 
+	std::vector<int> mBucket; 
+	mutable LinePairStats mStats; 
+
+public: 
+	LinePairFilter(float minAngle = CV_PI / 180, float collinearDistance = 2.0f); 
+
+	void setLines(const std::vector<cv::Vec4i> & lines); 
+	bool accept(size_t i, size_t j) const; 
+	// draws two distinct lines, redrawing a rejected pair up to maxDraws
+	// times; false if every draw was rejected
+	bool samplePair(cv::RNG & rng, size_t & i, size_t & j, int maxDraws = 16) const; 
+
+	const LinePairStats & getStats() const; 
+
+protected:
+	bool collinear(const cv::Vec4i & a, const cv::Vec4i & b) const; 
+}; 
+
+#endif
@@ -0,0 +1,46 @@
+#include "Log.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+#ifdef __ANDROID__
+#include <android/log.h>
+#endif
+
+namespace
+{
+
+volatile int gLogLevel = LOG_MIN_LEVEL; 
+
+}
+
+void
+logSetLevel(int level)
+{
+	gLogLevel = level; 
+}
+
+int
+logGetLevel()
+{
+	return gLogLevel; 
+}
+
+void
+logPrint(int level, const char * tag, const char * format, ...)
+{
+	va_list args; 
+	va_start(args, format); 
+#ifdef __ANDROID__
+	static const int priorities[] = { ANDROID_LOG_VERBOSE, ANDROID_LOG_DEBUG, ANDROID_LOG_INFO, 
+									  ANDROID_LOG_WARN, ANDROID_LOG_ERROR }; 
+	int priority = (level >= 0 && level < LOG_LEVEL_NONE) ? priorities[level] : ANDROID_LOG_ERROR; 
+	__android_log_vprint(priority, tag, format, args); 
+#else
+	static const char * names = "VDIWE"; 
+	fprintf(stderr, "%c/%s: ", (level >= 0 && level < LOG_LEVEL_NONE) ? names[level] : 'E', tag); 
+	vfprintf(stderr, format, args); 
+	fputc('\n', stderr); 
+#endif
+	va_end(args); 
+}
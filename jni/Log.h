@@ -0,0 +1,70 @@
+#ifndef LOG_H
+#define LOG_H
+
+// Native logging. A level below LOG_MIN_LEVEL is removed by the preprocessor,
+// arguments included; the others are checked against the runtime level
+// before anything is formatted. Goes to the Android log on the device and to
+// stderr elsewhere.
+//
+//	LOGD("Calibration::Native", "%d inliers", inliers); 
+
+#define LOG_LEVEL_VERBOSE 0
+#define LOG_LEVEL_DEBUG 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_WARN 3
+#define LOG_LEVEL_ERROR 4
+#define LOG_LEVEL_NONE 5
+
+#ifndef LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO
+#else
+#define LOG_MIN_LEVEL LOG_LEVEL_DEBUG
+#endif
+#endif
+
+// the debug windows of the vanishing point detectors need highgui and a
+// display, they are only built on request
+#ifndef LOG_SHOW_IMAGES
+#define LOG_SHOW_IMAGES 0
+#endif
+
+void logSetLevel(int level); 
+int logGetLevel(); 
+void logPrint(int level, const char * tag, const char * format, ...) __attribute__((format(printf, 3, 4))); 
+
+#define LOG_ENABLED(level) ((level) >= LOG_MIN_LEVEL && (level) >= logGetLevel())
+#define LOG_PRINT(level, tag, ...) \
+	do { if (LOG_ENABLED(level)) logPrint(level, tag, __VA_ARGS__); } while (0)
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_VERBOSE
+#define LOGV(tag, ...) LOG_PRINT(LOG_LEVEL_VERBOSE, tag, __VA_ARGS__)
+#else
+#define LOGV(tag, ...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+#define LOGD(tag, ...) LOG_PRINT(LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
+#else
+#define LOGD(tag, ...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+#define LOGI(tag, ...) LOG_PRINT(LOG_LEVEL_INFO, tag, __VA_ARGS__)
+#else
+#define LOGI(tag, ...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARN
+#define LOGW(tag, ...) LOG_PRINT(LOG_LEVEL_WARN, tag, __VA_ARGS__)
+#else
+#define LOGW(tag, ...) ((void)0)
+#endif
+
+#if LOG_MIN_LEVEL <= LOG_LEVEL_ERROR
+#define LOGE(tag, ...) LOG_PRINT(LOG_LEVEL_ERROR, tag, __VA_ARGS__)
+#else
+#define LOGE(tag, ...) ((void)0)
+#endif
+
+#endif
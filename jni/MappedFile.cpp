@@ -0,0 +1,68 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+MappedFile::MappedFile()
+	: mData(NULL), 
+	  mSize(0)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close(); 
+}
+
+bool
+MappedFile::open(const char * path)
+{
+	close(); 
+	if (!path) return false; 
+	int fd = ::open(path, O_RDONLY); 
+	if (fd < 0) return false; 
+
+	struct stat st; 
+	if (fstat(fd, &st) != 0 || st.st_size <= 0)
+	{
+		::close(fd); 
+		return false; 
+	}
+
+	// the mapping stays valid after the descriptor is closed
+	void * data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0); 
+	::close(fd); 
+	if (data == MAP_FAILED) return false; 
+
+	mData = static_cast<const char *>(data); 
+	mSize = st.st_size; 
+	return true; 
+}
+
+void
+MappedFile::close()
+{
+	if (mData) munmap(const_cast<char *>(mData), mSize); 
+	mData = NULL; 
+	mSize = 0; 
+}
+
+bool
+MappedFile::isOpen() const
+{
+	return mData != NULL; 
+}
+
+const char *
+MappedFile::data() const
+{
+	return mData; 
+}
+
+size_t
+MappedFile::size() const
+{
+	return mSize; 
+}
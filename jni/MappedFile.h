@@ -0,0 +1,29 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+
+// Read-only memory mapping of a whole file. The pages are loaded by the
+// kernel as they are touched, so records are read in place without copies.
+class MappedFile
+{
+	const char * mData; 
+	size_t mSize; 
+
+	// not copyable, the mapping is released in the destructor
+	MappedFile(const MappedFile &); 
+	MappedFile & operator=(const MappedFile &); 
+
+public: 
+	MappedFile(); 
+	~MappedFile(); 
+
+	bool open(const char * path); 
+	void close(); 
+	bool isOpen() const; 
+
+	const char * data() const; 
+	size_t size() const; 
+}; 
+
+#endif
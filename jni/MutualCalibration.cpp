@@ -1,23 +1,38 @@
 #include <cassert>
+#include <cstring>
 #include <algorithm>
 #include <vector>
-#include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/calib3d/calib3d.hpp>
 
-
-#include <android/log.h>
-
+#include "CalibrationFile.h"
 #include "CataCameraParameters.h"
 #include "Chessboard.h"
-#include "Cas1DVanishingPoint.h"
-#include "RansacVanishingPoint.h"
+#include "Log.h"
+#include "VanishingPointEngine.h"
 #include "MutualCalibration.h"
 
+// doubles written by getCalibrationResults and getFrameState
+#define CALIBRATION_RESULTS_SIZE 18
+#define FRAME_STATE_SIZE 27
+
+namespace
+{
+
+class StateLock
+{
+	pthread_mutex_t & mMutex; 
+
+public: 
+	explicit StateLock(pthread_mutex_t & mutex) : mMutex(mutex) { pthread_mutex_lock(&mMutex); }
+	~StateLock() { pthread_mutex_unlock(&mMutex); }
+}; 
+
+}
+
 void showMat(cv::Mat R, const char* s)
 {
-	__android_log_print(
-			ANDROID_LOG_INFO, s, "%lf %lf %lf \n %lf %lf %lf \n %lf %lf %lf\n",
+	LOGD(s, "%lf %lf %lf \n %lf %lf %lf \n %lf %lf %lf\n",
 			R.at<double>(0, 0), R.at<double>(0, 1), R.at<double>(0, 2),
 			R.at<double>(1, 0), R.at<double>(1, 1), R.at<double>(1, 2),
 			R.at<double>(2, 0), R.at<double>(2, 1), R.at<double>(2, 2));
@@ -31,45 +46,116 @@ MutualCalibration::MutualCalibration(size_t heightImage, size_t widthImage, size
 									 bool useOpenCVCorner, bool useOnlyIMUGravity, bool useRANSAC)
 	: mImageSize(cv::Size(widthImage, heightImage)), 
 	  mBoardSize(cv::Size(widthBoard, heightBoard)), 
+	  mSquareSize(1.0f),
+	  mRotationCalibrated(false),
 	  mUseOpenCVCorner(useOpenCVCorner),
-	  mUseOnlyIMUGravity(useOnlyIMUGravity),
 	  mUseOpenCVCalibration(false),
+	  mUseOnlyIMUGravity(useOnlyIMUGravity),
 	  mUseChessboardHorizontal(false),
 	  mUseRANSAC(useRANSAC),
 	  mChessboardMeasured(false), 
 	  mChessboardImages(0), 
 	  mVanishingPointImages(0),
-	  mSquareSize(1.0f)
+	  mDrawOverlay(true),
+	  mIMU(useOnlyIMUGravity),
+	  mUseIncrementalCalibration(false),
+	  mPendingViews(0),
+	  mObservationTimestamp(-1),
+	  mKeyframes(cv::Size(widthImage, heightImage)),
+	  mBoardsPerFrame(1),
+	  mUsePartialBoards(false),
+	  mIntrinsics(cv::Size(widthImage, heightImage)),
+	  mPipeline(processPipelineFrame, this)
 {
+	pthread_mutexattr_t attributes; 
+	pthread_mutexattr_init(&attributes); 
+	pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE); 
+	pthread_mutex_init(&mStateMutex, &attributes); 
+	pthread_mutexattr_destroy(&attributes); 
+	pthread_mutex_init(&mOverlayMutex, NULL); 
+
+	mBoardPoints = createBoardPoints(cv::Rect(cv::Point(), mBoardSize)); 
+	mBoardSizes.push_back(mBoardSize); 
+	mIntrinsics.setEnabled(false); 
+}
+
+MutualCalibration::~MutualCalibration()
+{
+	// the worker may hold the lock until it is joined
+	mPipeline.stop(); 
+	pthread_mutex_destroy(&mStateMutex); 
+	pthread_mutex_destroy(&mOverlayMutex); 
 }
 
 size_t 
 MutualCalibration::getNumberOfImages() const
 {
+	StateLock lock(mStateMutex); 
 	assert(mChessboardImages == 0 || mVanishingPointImages == 0);
 	return std::max(mChessboardImages, mVanishingPointImages); 
 }
 
+double
+MutualCalibration::getFocalConfidence() const
+{
+	StateLock lock(mStateMutex); 
+	return mFocalEstimator.getConfidence(); 
+}
+
 void
 MutualCalibration::getRotationMatrix(double p[]) const
 {
+	StateLock lock(mStateMutex); 
 	// store columnwise
-	cv::Mat mCamera2IMU2;
-	cv::transpose(mCamera2IMU, mCamera2IMU2);
-	p[0] = mCamera2IMU2.at<double>(0, 0);
-	p[1] = mCamera2IMU2.at<double>(0, 1);
-	p[2] = mCamera2IMU2.at<double>(0, 2);
-	p[3] = mCamera2IMU2.at<double>(1, 0);
-	p[4] = mCamera2IMU2.at<double>(1, 1);
-	p[5] = mCamera2IMU2.at<double>(1, 2);
-	p[6] = mCamera2IMU2.at<double>(2, 0);
-	p[7] = mCamera2IMU2.at<double>(2, 1);
-	p[8] = mCamera2IMU2.at<double>(2, 2);
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 3; j++)
+			p[3 * i + j] = mCamera2IMU(j, i); 
+}
+
+void
+MutualCalibration::setIncrementalCalibration(bool enable)
+{
+	StateLock lock(mStateMutex); 
+	// keeps the gravity cross-covariance up to date as images are added, so
+	// that the rotation is available at any time
+	mUseIncrementalCalibration = enable; 
+}
+
+bool
+MutualCalibration::getOnlineRotationMatrix(double p[]) const
+{
+	StateLock lock(mStateMutex); 
+	// same layout as getRotationMatrix
+	cv::Matx33d R; 
+	double conditioning; 
+	bool wellPosed = mKabsch.getRotation(R, conditioning); 
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 3; j++)
+			p[3 * i + j] = R(j, i); 
+	return wellPosed; 
+}
+
+double
+MutualCalibration::getOnlineConditioning() const
+{
+	StateLock lock(mStateMutex); 
+	cv::Matx33d R; 
+	double conditioning; 
+	mKabsch.getRotation(R, conditioning); 
+	return conditioning; 
 }
 
 void
 MutualCalibration::getCameraMatrix(double p[]) const
 {
+	StateLock lock(mStateMutex); 
+	// zeros until there is a camera matrix, from calibrateCamera, the
+	// incremental intrinsics or loadCalibration
+	if (mKCamera.empty())
+	{
+		std::fill(p, p + 9, 0.0); 
+		return; 
+	}
 	// store columnwise
 	cv::Mat mKCamera2;
 	cv::transpose(mKCamera, mKCamera2);
@@ -84,302 +170,1238 @@ MutualCalibration::getCameraMatrix(double p[]) const
 	p[8] = mKCamera2.at<double>(2, 2);
 }
 
-std::vector<size_t>
-MutualCalibration::randPerm(size_t n) const 
+void
+MutualCalibration::getRansacStats(double p[]) const
 {
-	std::vector<size_t> perm; 
-	for(size_t i = 0; i < n; i++) perm.push_back(i);
-
-	for(size_t i = 0; i < n; i++) 
-	{	
-		size_t j = rand() % (n - i) + i;
-
-		size_t t = perm[j];
-		perm[j] = perm[i];
-		perm[i] = t;
-	}
-
-	return perm; 
+	StateLock lock(mStateMutex); 
+	// samples, iterations, inliers and milliseconds of the last RANSAC
+	// mutualCalibrate
+	p[0] = mRansacStats.samples; 
+	p[1] = mRansacStats.iterations; 
+	p[2] = mRansacStats.inliers; 
+	p[3] = mRansacStats.milliseconds; 
 }
 
 void 
 MutualCalibration::addFullIMURotationByQuaternion(double r0, double r1, double r2)
 {
+	StateLock lock(mStateMutex); 
 	assert(!mUseOnlyIMUGravity);
+	cv::Matx33d RIMU = rotationFromQuaternion(r0, r1, r2); 
+
+	// the third column of the transpose, i.e. the third row
+	addPendingIMUReading(cv::Vec3d(RIMU(2, 0), RIMU(2, 1), RIMU(2, 2))); 
+
+	if (mSessionLog.isLogging())
+	{
+		double record[3] = { r0, r1, r2 }; 
+		mSessionLog.append(SESSION_IMU_QUATERNION, mObservationTimestamp, record, sizeof(record)); 
+	}
+}
+
+cv::Mat
+MutualCalibration::rotationFromQuaternion(double r0, double r1, double r2) const
+{
+	// (r0, r1, r2) is the vector part of a unit quaternion, as delivered by
+	// the rotation vector sensor
 	cv::Mat rvec(3, 1, CV_64F); 
 	rvec.at<double>(0) = r0; 
 	rvec.at<double>(1) = r1; 
 	rvec.at<double>(2) = r2; 
 	double a = cv::norm(rvec); 
+	if (a < 1e-12) return cv::Mat::eye(3, 3, CV_64F); 
 
-	a = 2 * asin(a); 
+	a = 2 * asin(std::min(a, 1.0)); 
 	rvec = rvec / cv::norm(rvec) * a; 
 
-	cv::Mat RIMU; 
-	cv::Rodrigues(rvec, RIMU); 
+	cv::Mat R; 
+	cv::Rodrigues(rvec, R); 
+	return R; 
+}
 
-	RIMU = RIMU.t(); 
-	mgsIMU.push_back(RIMU.col(2) * 1.0);
+void
+MutualCalibration::setVanishingPointTracking(bool enable)
+{
+	StateLock lock(mStateMutex); 
+	mTracker.setEnabled(enable); 
+}
+
+void
+MutualCalibration::setIMURotationDelta(double r0, double r1, double r2)
+{
+	StateLock lock(mStateMutex); 
+	// rotation of the device since the previous vanishing point image, used
+	// to predict the Manhattan frame of the next one
+	mTracker.setIMURotationDelta(rotationFromQuaternion(r0, r1, r2)); 
 }
 
 void
 MutualCalibration::addIMUGravityVector(double g1, double g2, double g3)
 {
+	StateLock lock(mStateMutex); 
 	assert(mUseOnlyIMUGravity);
-	cv::Mat g(3, 1, CV_64F); 
-	g.at<double>(0) = g1; 
-	g.at<double>(1) = g2; 
-	g.at<double>(2) = g3; 
-	mgsIMU.push_back(g * 1.0); 
-	cv::normalize(mgsIMU.back(), mgsIMU.back()); 
+	addPendingIMUReading(cv::normalize(cv::Vec3d(g1, g2, g3))); 
+
+	if (mSessionLog.isLogging())
+	{
+		double record[3] = { g1, g2, g3 }; 
+		mSessionLog.append(SESSION_IMU_GRAVITY, mObservationTimestamp, record, sizeof(record)); 
+	}
+}
+
+void
+MutualCalibration::addPendingIMUReading(const cv::Vec3d & gravity)
+{
+	// the reading belongs to every view of the last accepted image; with no
+	// view waiting for one there is nothing to pair it with
+	if (mPendingViews == 0)
+		LOGW("MutualCalibration", "imu reading without a view, ignored"); 
+	for (size_t i = mViews.size() - mPendingViews; i < mViews.size(); i++)
+	{
+		CalibrationView & view = mViews[i]; 
+		view.gIMU = gravity; 
+		view.imuKnown = true; 
+		if (mUseIncrementalCalibration && view.rotationKnown)
+			mKabsch.add(findCameraGravity(view.R, gravity), gravity); 
+	}
+	mPendingViews = 0; 
+}
+
+void
+MutualCalibration::addIMUSample(long long timestamp, double x, double y, double z)
+{
+	// called from the sensor callback, for the sensor matching the
+	// calibration mode: gravity or rotation vector
+	mIMU.push(timestamp, x, y, z); 
+}
+
+void
+MutualCalibration::setIMUTimeConstant(double seconds)
+{
+	StateLock lock(mStateMutex); 
+	mIMU.setTimeConstant(seconds); 
+}
+
+bool
+MutualCalibration::getIMUAtTimestamp(long long timestamp, double p[]) const
+{
+	// the value to pass to addIMUGravityVector or addFullIMURotationByQuaternion
+	// for a frame exposed at the given time, on the sensor clock
+	return mIMU.lookup(timestamp, p); 
 }
 
 bool 
 MutualCalibration::tryAddingChessboardImage(cv::Mat & inputImage, cv::Mat & outputImage)
 {
-	vcharge::Chessboard chessboard(mBoardSize, inputImage); 
-	chessboard.findCorners(mUseOpenCVCorner); 
-	chessboard.getSketch().copyTo(outputImage); 
+	StateLock lock(mStateMutex); 
+	Overlay overlay; 
+	bool success = addChessboardImage(inputImage, overlay); 
+	renderOverlay(overlay, inputImage, outputImage); 
+	storeOverlay(overlay); 
+	return success; 
+}
+
+bool
+MutualCalibration::tryAddingVanishingPointImage(cv::Mat & inputImage, cv::Mat & outputImage)
+{
+	StateLock lock(mStateMutex); 
+	Overlay overlay; 
+	bool success = addVanishingPointImage(inputImage, overlay); 
+	renderOverlay(overlay, inputImage, outputImage); 
+	storeOverlay(overlay); 
+	return success; 
+}
+
+bool
+MutualCalibration::tryAddingNV21Image(char * nv21, size_t length, int mode, cv::Mat & outputImage)
+{
+	StateLock lock(mStateMutex); 
+	if (!checkNV21Length(length)) return false; 
+	// the Y plane is the gray image, used in place; the only full frame
+	// conversion is the one producing the rgba output
+	cv::Mat yuv(mImageSize.height * 3 / 2, mImageSize.width, CV_8UC1, nv21); 
+	cv::Mat gray = yuv.rowRange(0, mImageSize.height); 
+	cv::cvtColor(yuv, outputImage, CV_YUV2RGBA_NV21); 
+	Overlay overlay; 
+	bool success = addImage(gray, mode, overlay); 
+	renderOverlay(overlay, gray, outputImage); 
+	storeOverlay(overlay); 
+	return success; 
+}
+
+void
+MutualCalibration::setOverlayDrawing(bool enable)
+{
+	StateLock lock(mStateMutex); 
+	mDrawOverlay = enable; 
+}
+
+size_t
+MutualCalibration::getOverlaySize() const
+{
+	StateLock lock(mOverlayMutex); 
+	return mOverlay.getPackedSize(); 
+}
+
+void
+MutualCalibration::getOverlay(float p[]) const
+{
+	StateLock lock(mOverlayMutex); 
+	mOverlay.pack(p); 
+}
+
+void
+MutualCalibration::storeOverlay(const Overlay & overlay)
+{
+	StateLock lock(mOverlayMutex); 
+	mOverlay = overlay; 
+}
+
+bool
+MutualCalibration::addImage(const cv::Mat & image, int mode, Overlay & overlay, int64 timestamp)
+{
+	// the time the observation is logged with, also for the imu reading that
+	// follows it
+	mObservationTimestamp = timestamp >= 0 ? timestamp : sessionTimestamp(); 
+	if (mode == PIPELINE_MODE_CHESSBOARD)
+		return addChessboardImage(image, overlay); 
+	else
+		return addVanishingPointImage(image, overlay); 
+}
+
+bool
+MutualCalibration::addChessboardImage(const cv::Mat & image, Overlay & overlay)
+{
+	cv::Mat input = image; 
+	vcharge::Chessboard chessboard(mBoardSize, input); 
+	chessboard.setPartialBoards(mUsePartialBoards); 
+	chessboard.findBoards(mBoardSizes, mBoardsPerFrame, mUseOpenCVCorner); 
+	overlay.clear(); 
+	chessboard.getOverlay(overlay); 
+	mPendingViews = 0; 
 	if (!chessboard.cornersFound())
 		return false; 
-	else 
+
+	// every board is a view of its own; one too close to the ones already
+	// kept is not added, and if none is the image is reported as not added,
+	// so that no imu reading is added for it either
+	cv::Vec3d gravity; 
+	bool gravityKnown = mKeyframes.isEnabled() && getObservationGravity(gravity); 
+	const std::vector<vcharge::ChessboardDetection> & boards = chessboard.getBoards(); 
+	for (size_t i = 0; i < boards.size(); i++)
+	{
+		if (!mKeyframes.select(boards[i].corners, boards[i].gridSize, gravityKnown ? &gravity : NULL))
+			continue; 
+		acceptChessboardCorners(boards[i].corners, cv::Rect(boards[i].gridOffset, boards[i].gridSize)); 
+	}
+	return mPendingViews > 0; 
+}
+
+bool
+MutualCalibration::getObservationGravity(cv::Vec3d & gravity) const
+{
+	// gravity in the imu frame at the time of the current observation, from
+	// the sample buffer; only available when the samples are being pushed
+	double p[3]; 
+	if (!getIMUAtTimestamp(mObservationTimestamp, p)) return false; 
+	if (mUseOnlyIMUGravity)
+		gravity = cv::Vec3d(p[0], p[1], p[2]); 
+	else
 	{
-		mImagePoints.push_back(chessboard.getCorners()); 
-		mChessboardImages++; 
+		// as in addFullIMURotationByQuaternion
+		cv::Matx33d RIMU = rotationFromQuaternion(p[0], p[1], p[2]); 
+		gravity = cv::Vec3d(RIMU(2, 0), RIMU(2, 1), RIMU(2, 2)); 
+	}
+	return true; 
+}
+
+void
+MutualCalibration::acceptChessboardCorners(const std::vector<cv::Point2f> & corners, const cv::Rect & grid)
+{
+	// the corners of a partial board keep their place on the whole board; a
+	// board of another size has its own points
+	std::vector<cv::Point3f> partialPoints; 
+	if (grid != cv::Rect(cv::Point(), mBoardSize)) partialPoints = createBoardPoints(grid); 
+	const std::vector<cv::Point3f> & boardPoints = partialPoints.empty() ? mBoardPoints : partialPoints; 
+
+	// refines K as the views come in, so that it is known before
+	// calibrateCamera
+	if (mIntrinsics.addView(boardPoints, corners) && mIntrinsics.available())
+	{
+		mKCamera = mIntrinsics.getCameraMatrix(); 
+		mDistCamera = mIntrinsics.getDistortion(); 
+	}
+
+	// once the intrinsics are known, from the above or an earlier
+	// calibrateCamera, the board pose gives the rotation for the online
+	// estimate
+	CalibrationView view; 
+	if (mUseIncrementalCalibration && cameraMatrixKnown())
+	{
+		cv::Mat rvec, tvec, R; 
+		cv::solvePnP(boardPoints, corners, mKCamera, mDistCamera, rvec, tvec); 
+		cv::Rodrigues(rvec, R); 
+		view.R = cv::Matx33d(R); 
+		view.rotationKnown = true; 
+	}
+	view.points = (int)mImagePoints.size(); 
+	mViews.push_back(view); 
+	mImagePoints.push_back(corners); 
+	mViewGrids.push_back(grid); 
+	mChessboardImages++; 
+	mPendingViews++; 
+
+	if (mSessionLog.isLogging() && !corners.empty())
+	{
+		if (partialPoints.empty())
+			mSessionLog.append(SESSION_CHESSBOARD, mObservationTimestamp, &corners[0], corners.size() * sizeof(cv::Point2f)); 
+		else
+		{
+			std::vector<cv::Point2f> record; 
+			record.push_back(cv::Point2f(grid.width, grid.height)); 
+			record.push_back(cv::Point2f(grid.x, grid.y)); 
+			record.insert(record.end(), corners.begin(), corners.end()); 
+			mSessionLog.append(SESSION_PARTIAL_CHESSBOARD, mObservationTimestamp, &record[0], record.size() * sizeof(cv::Point2f)); 
+		}
+	}
+}
+
+bool
+MutualCalibration::addVanishingPointImage(const cv::Mat & image, Overlay & overlay)
+{
+	// try the previous Manhattan frame first, rotated by the IMU motion since
+	// then, and only run the full search if it lost its support
+	cv::Mat prediction = mTracker.predict(createAlignmentMatrix()); 
+	VanishingPointEngine * vanishingPoint = mEngines.process(image, prediction, mTracker.getFocal()); 
+
+	overlay.clear(); 
+	vanishingPoint->getOverlay(overlay); 
+	mPendingViews = 0; 
+	if (vanishingPoint->getStats().success)
+	{
+		acceptVanishingPoint(vanishingPoint->getRotation(), vanishingPoint->getFocal()); 
 		return true; 
 	}
+	else 
+	{
+		mTracker.lose(); 
+		return false; 
+	}
+}
+
+void
+MutualCalibration::acceptVanishingPoint(const cv::Mat & rotation, float focal)
+{
+	cv::Matx33d R(rotation); 
+	CalibrationView view; 
+	view.R = R; 
+	view.rotationKnown = true; 
+	mViews.push_back(view); 
+	mVanishingPointImages++; 
+	mPendingViews++; 
+
+	// keep K up to date without storing the per-image focals
+	mFocalEstimator.update(focal); 
+	if (mFocalEstimator.available())
+		updateCameraMatrixFromFocal(mFocalEstimator.getFocal()); 
+
+	mTracker.update(rotation, focal); 
+
+	if (mSessionLog.isLogging())
+	{
+		double record[10]; 
+		for (int i = 0; i < 9; i++)
+			record[i] = R(i / 3, i % 3); 
+		record[9] = focal; 
+		mSessionLog.append(SESSION_VANISHING_POINT, mObservationTimestamp, record, sizeof(record)); 
+	}
+}
+
+void
+MutualCalibration::renderOverlay(const Overlay & overlay, const cv::Mat & image, cv::Mat & outputImage) const
+{
+	// with drawing disabled the caller draws getOverlay() itself and the
+	// output is left untouched; when it already holds the frame, e.g. the
+	// rgba preview, only the detections are drawn on it
+	if (!mDrawOverlay) return; 
+	if (outputImage.size() != image.size())
+		cv::cvtColor(image, outputImage, CV_GRAY2BGR); 
+	overlay.draw(outputImage); 
+}
+
+void
+MutualCalibration::setVanishingPointEngine(int engine)
+{
+	StateLock lock(mStateMutex); 
+	mEngines.select(engine); 
+	mTracker.lose(); 
+}
+
+void
+MutualCalibration::setParallelVanishingPointEngines(bool enable)
+{
+	StateLock lock(mStateMutex); 
+	mEngines.setParallel(enable); 
+}
+
+bool
+MutualCalibration::setCameraParameters(int width, int height, double xi, double k1, double k2, double p1, double p2, 
+									   double gamma1, double gamma2, double u0, double v0)
+{
+	StateLock lock(mStateMutex); 
+	return setUndistortion(vcharge::CataCameraParameters(width, height, xi, k1, k2, p1, p2, gamma1, gamma2, u0, v0)); 
+}
+
+bool
+MutualCalibration::loadCameraParameters(const char * path)
+{
+	StateLock lock(mStateMutex); 
+	// the yaml file written by CataCameraParameters::write
+	vcharge::CataCameraParameters parameters; 
+	return parameters.read(path) && setUndistortion(parameters); 
+}
+
+bool
+MutualCalibration::setUndistortion(const vcharge::CataCameraParameters & parameters)
+{
+	// the tables are built once per parameter set and shared, so this is
+	// cheap after the first call
+	if (parameters.imageWidth() != mImageSize.width || parameters.imageHeight() != mImageSize.height
+		|| parameters.gamma1() <= 0 || parameters.gamma2() <= 0)
+		return false; 
+	mUndistortion = UndistortionMap::get(parameters); 
+	mEngines.setUndistortion(mUndistortion); 
+	return true; 
+}
+
+void
+MutualCalibration::getVanishingPointStats(double p[]) const
+{
+	StateLock lock(mStateMutex); 
+	// per engine: success, tracked, lines, support, milliseconds, line pairs
+	// tested, line pairs rejected; followed by the engine whose result was
+	// used for the last image
+	for (int i = 0; i < VP_ENGINE_COUNT; i++)
+	{
+		const VanishingPointStats & stats = mEngines.getEngine(i).getStats(); 
+		p[7 * i + 0] = stats.success; 
+		p[7 * i + 1] = stats.tracked; 
+		p[7 * i + 2] = stats.lines; 
+		p[7 * i + 3] = stats.support; 
+		p[7 * i + 4] = stats.milliseconds; 
+		p[7 * i + 5] = stats.pairs.tested; 
+		p[7 * i + 6] = stats.pairs.rejected(); 
+	}
+	p[7 * VP_ENGINE_COUNT] = mEngines.getLastType(); 
+}
+
+void
+MutualCalibration::setLogLevel(int level)
+{
+	// LOG_LEVEL_* from Log.h; levels compiled out by LOG_MIN_LEVEL stay off
+	logSetLevel(level); 
 }
 
 bool
-MutualCalibration::tryAddingVanishingPointImage(cv::Mat & inputImage, cv::Mat & outputImage)
+MutualCalibration::startFramePipeline()
+{
+	return mPipeline.start(); 
+}
+
+void
+MutualCalibration::stopFramePipeline()
+{
+	mPipeline.stop(); 
+}
+
+bool
+MutualCalibration::enqueueFrame(cv::Mat & inputImage, cv::Mat & outputImage, int mode, double s0, double s1, double s2)
+{
+	double sensor[3] = {s0, s1, s2}; 
+	return mPipeline.enqueue(inputImage, outputImage, mode, sensor); 
+}
+
+bool
+MutualCalibration::enqueueNV21Frame(char * nv21, size_t length, int mode, double s0, double s1, double s2)
+{
+	if (!checkNV21Length(length)) return false; 
+	double sensor[3] = {s0, s1, s2}; 
+	cv::Mat yuv(mImageSize.height * 3 / 2, mImageSize.width, CV_8UC1, nv21); 
+	return mPipeline.enqueueNV21(yuv, mode, sensor); 
+}
+
+bool
+MutualCalibration::enqueueTimedNV21Frame(char * nv21, size_t length, int mode, long long timestamp, double s0, double s1, double s2)
+{
+	// the imu is looked up at the timestamp when the worker takes the frame,
+	// by then the samples after the exposure have arrived; the given reading
+	// is only used if the buffer does not cover the timestamp
+	if (!checkNV21Length(length)) return false; 
+	double sensor[3] = {s0, s1, s2}; 
+	cv::Mat yuv(mImageSize.height * 3 / 2, mImageSize.width, CV_8UC1, nv21); 
+	return mPipeline.enqueueNV21(yuv, mode, sensor, timestamp); 
+}
+
+int
+MutualCalibration::pollFrameResult(cv::Mat & outputImage)
+{
+	// -1 when no new frame was processed since the last call, otherwise
+	// whether the processed frame was added; the pipeline worker holds
+	// mStateMutex for a whole frame, so only the overlay is locked here
+	bool success; 
+	Overlay overlay; 
+	if (!mPipeline.poll(outputImage, overlay, success)) return -1; 
+	storeOverlay(overlay); 
+	return success ? 1 : 0; 
+}
+
+void
+MutualCalibration::getFramePipelineStats(double p[]) const
+{
+	PipelineStats stats = mPipeline.getStats(); 
+	p[0] = stats.enqueued; 
+	p[1] = stats.dropped; 
+	p[2] = stats.processed; 
+	p[3] = stats.accepted; 
+}
+
+void
+MutualCalibration::setSquareSize(float size)
 {
-	RansacVanishingPoint vanishingPoint(inputImage); 
-	vanishingPoint.findOrthogonalVanishingPts(); 
-	vanishingPoint.getSketch().copyTo(outputImage); 
-	if (vanishingPoint.orthogonalityDetected())
+	StateLock lock(mStateMutex); 
+	// only scales the board translations, K and the rotations do not depend
+	// on it; to be set before the first view
+	mSquareSize = size; 
+	mBoardPoints = createBoardPoints(cv::Rect(cv::Point(), mBoardSize)); 
+}
+
+void
+MutualCalibration::setBoardsPerFrame(int boards)
+{
+	StateLock lock(mStateMutex); 
+	// several boards of mBoardSize in view give as many views per
+	// detection, each paired with the imu reading of the frame
+	mBoardsPerFrame = std::max(boards, 1); 
+}
+
+void
+MutualCalibration::addBoardSize(int heightBoard, int widthBoard)
+{
+	StateLock lock(mStateMutex); 
+	// boards of another size found in the same frames are views of their
+	// own, with object points on that board; the square size is shared
+	cv::Size size(widthBoard, heightBoard); 
+	if (size.width < 2 || size.height < 2) return; 
+	if (std::find(mBoardSizes.begin(), mBoardSizes.end(), size) == mBoardSizes.end())
+		mBoardSizes.push_back(size); 
+}
+
+void
+MutualCalibration::setPartialBoards(bool enable)
+{
+	StateLock lock(mStateMutex); 
+	// boards with rows or columns cut off by the image border are added
+	// with the corners that are left, see Chessboard::setPartialBoards
+	mUsePartialBoards = enable; 
+}
+
+void
+MutualCalibration::setKeyframeSelection(bool enable)
+{
+	StateLock lock(mStateMutex); 
+	// only chessboard views are selected, see KeyframeSelector.h
+	mKeyframes.setEnabled(enable); 
+}
+
+void
+MutualCalibration::getKeyframeStats(double p[]) const
+{
+	StateLock lock(mStateMutex); 
+	// views considered, kept and rejected
+	const KeyframeStats & stats = mKeyframes.getStats(); 
+	p[0] = stats.considered; 
+	p[1] = stats.accepted; 
+	p[2] = stats.rejected(); 
+}
+
+void
+MutualCalibration::setIncrementalIntrinsics(bool enable)
+{
+	StateLock lock(mStateMutex); 
+	// refines K and the distortion with every chessboard view, see
+	// IncrementalIntrinsics.h; calibrateCamera then only solves the poses
+	mIntrinsics.setEnabled(enable); 
+}
+
+bool
+MutualCalibration::getOnlineCameraMatrix(double p[]) const
+{
+	StateLock lock(mStateMutex); 
+	// same layout as getCameraMatrix
+	if (!mIntrinsics.available()) return false; 
+	cv::Mat K = mIntrinsics.getCameraMatrix(); 
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 3; j++)
+			p[3 * i + j] = K.at<double>(j, i); 
+	return true; 
+}
+
+double
+MutualCalibration::getOnlineReprojectionError() const
+{
+	StateLock lock(mStateMutex); 
+	return mIntrinsics.getRMS(); 
+}
+
+void
+MutualCalibration::setViewErrorThreshold(double pixels)
+{
+	StateLock lock(mStateMutex); 
+	// views whose reprojection error is above it are left out of
+	// mutualCalibrate by the next calibrateCamera, which judges all the
+	// views again
+	mViewRefinement.setThreshold(pixels); 
+}
+
+void
+MutualCalibration::getViewRefinementStats(double p[]) const
+{
+	StateLock lock(mStateMutex); 
+	const ViewRefinementStats & stats = mViewRefinement.getStats(); 
+	p[0] = stats.views; 
+	p[1] = stats.outliers; 
+	p[2] = stats.threads; 
+	p[3] = stats.rms; 
+	p[4] = stats.milliseconds; 
+}
+
+bool
+MutualCalibration::startSessionLog(const char * path)
+{
+	// every accepted observation from now on is appended to the file, see
+	// SessionLog.h for the layout
+	return mSessionLog.open(path, createSessionFileHeader(mImageSize, mBoardSize, mSquareSize)); 
+}
+
+void
+MutualCalibration::stopSessionLog()
+{
+	mSessionLog.close(); 
+}
+
+bool
+MutualCalibration::replaySession(const char * path)
+{
+	StateLock lock(mStateMutex); 
+	// adds the observations of a session log as if the images had been
+	// detected again; meant for a fresh object set up like the one that
+	// wrote the log, then calibrateCamera and mutualCalibrate as usual
+	SessionLogReader reader; 
+	if (!reader.open(path)) return false; 
+
+	const SessionFileHeader & header = reader.getHeader(); 
+	if (header.imageWidth != mImageSize.width || header.imageHeight != mImageSize.height
+		|| header.boardWidth != mBoardSize.width || header.boardHeight != mBoardSize.height)
+		return false; 
+
+	// the whole file is checked first, so that a bad record leaves the
+	// object as it was
+	std::vector<SessionRecord> records; 
+	SessionRecord record; 
+	while (reader.next(record))
 	{
-		cv::Mat R = vanishingPoint.getRotation(); 
-		std::vector<cv::Point2f> ovpts = vanishingPoint.selectOrthogonalVanishingPts();
+		if (!checkSessionRecord(record)) return false; 
+		records.push_back(record); 
+	}
+
+	if (header.squareSize > 0)
+		setSquareSize(header.squareSize); 
+	// the observations are already in a log, an open one does not get them again
+	mSessionLog.suspend(true); 
+	for (size_t i = 0; i < records.size(); i++)
+	{
+		mObservationTimestamp = records[i].timestamp; 
+		const double * values = reinterpret_cast<const double *>(records[i].data); 
+		const cv::Point2f * corners = reinterpret_cast<const cv::Point2f *>(records[i].data); 
+		size_t n = records[i].size / sizeof(cv::Point2f); 
+		switch (records[i].type)
+		{
+		case SESSION_CHESSBOARD:
+			acceptChessboardCorners(std::vector<cv::Point2f>(corners, corners + n), cv::Rect(cv::Point(), mBoardSize)); 
+			break; 
+		case SESSION_PARTIAL_CHESSBOARD:
+			acceptChessboardCorners(std::vector<cv::Point2f>(corners + 2, corners + n), 
+									cv::Rect(cvRound(corners[1].x), cvRound(corners[1].y), cvRound(corners[0].x), cvRound(corners[0].y))); 
+			break; 
+		case SESSION_VANISHING_POINT:
+			acceptVanishingPoint(cv::Mat(cv::Matx33d(values)), values[9]); 
+			break; 
+		case SESSION_IMU_GRAVITY:
+			addIMUGravityVector(values[0], values[1], values[2]); 
+			break; 
+		case SESSION_IMU_QUATERNION:
+			addFullIMURotationByQuaternion(values[0], values[1], values[2]); 
+			break; 
+		default:
+			// written by a newer version, skip
+			break; 
+		}
+	}
+	mSessionLog.suspend(false); 
+	return true; 
+}
 
-		
-		mRsCamera.push_back(R * 1.0);
-		mfsCamera.push_back(vanishingPoint.getFocal());
-		mVanishingPointImages++; 
+bool
+MutualCalibration::checkSessionRecord(const SessionRecord & record) const
+{
+	switch (record.type)
+	{
+	case SESSION_CHESSBOARD:
+		return record.size == mBoardSize.area() * sizeof(cv::Point2f); 
+	case SESSION_PARTIAL_CHESSBOARD:
+	{
+		const cv::Point2f * corners = reinterpret_cast<const cv::Point2f *>(record.data); 
+		size_t n = record.size / sizeof(cv::Point2f); 
+		if (n < 2 || record.size != n * sizeof(cv::Point2f)) return false; 
+		cv::Rect grid(cvRound(corners[1].x), cvRound(corners[1].y), cvRound(corners[0].x), cvRound(corners[0].y)); 
+		if (grid.width <= 0 || grid.height <= 0 || (size_t)grid.area() != n - 2) return false; 
+		// inside one of the boards, added with addBoardSize before replaying
+		for (size_t i = 0; i < mBoardSizes.size(); i++)
+			if ((grid & cv::Rect(cv::Point(), mBoardSizes[i])) == grid) return true; 
+		return false; 
+	}
+	case SESSION_VANISHING_POINT:
+		return record.size >= 10 * sizeof(double); 
+	case SESSION_IMU_GRAVITY:
+		// an imu reading of the other kind would be paired with the wrong
+		// image, give up instead
+		return mUseOnlyIMUGravity && record.size >= 3 * sizeof(double); 
+	case SESSION_IMU_QUATERNION:
+		return !mUseOnlyIMUGravity && record.size >= 3 * sizeof(double); 
+	default:
 		return true; 
 	}
-	else return false; 
+}
+
+bool
+MutualCalibration::saveCalibration(const char * path) const
+{
+	StateLock lock(mStateMutex); 
+	// the results in one checksummed binary record, see CalibrationFile.h
+	CalibrationRecord record = createCalibrationRecord(mImageSize.width, mImageSize.height); 
+	if (mUndistortion) setCataParameters(record, mUndistortion->getParameters()); 
+	if (cameraMatrixKnown())
+	{
+		record.flags |= CALIBRATION_CAMERA_MATRIX; 
+		cv::Mat K, distortion; 
+		mKCamera.convertTo(K, CV_64F); 
+		for (int i = 0; i < 9; i++)
+			record.cameraMatrix[i] = K.at<double>(i / 3, i % 3); 
+		if (!mDistCamera.empty())
+		{
+			mDistCamera.reshape(1, 1).convertTo(distortion, CV_64F); 
+			for (int i = 0; i < 5 && i < distortion.cols; i++)
+				record.distortion[i] = distortion.at<double>(0, i); 
+		}
+	}
+	if (mRotationCalibrated)
+	{
+		record.flags |= CALIBRATION_ROTATION; 
+		for (int i = 0; i < 9; i++)
+			record.rotation[i] = mCamera2IMU(i / 3, i % 3); 
+	}
+	sealCalibrationRecord(record); 
+	return writeCalibrationFile(path, &record, 1); 
+}
+
+bool
+MutualCalibration::loadCalibration(const char * path)
+{
+	StateLock lock(mStateMutex); 
+	// the first record of a file written by saveCalibration, if it is intact
+	// and for this resolution
+	CalibrationFileReader reader; 
+	if (!reader.open(path)) return false; 
+	const CalibrationRecord * record = reader.getRecord(0); 
+	if (!record || record->imageWidth != mImageSize.width || record->imageHeight != mImageSize.height)
+		return false; 
+
+	if (record->flags & CALIBRATION_CAMERA_MATRIX)
+	{
+		cv::Mat(3, 3, CV_64F, const_cast<double *>(record->cameraMatrix)).copyTo(mKCamera); 
+		cv::Mat(5, 1, CV_64F, const_cast<double *>(record->distortion)).copyTo(mDistCamera); 
+	}
+	if (record->flags & CALIBRATION_ROTATION)
+	{
+		mCamera2IMU = cv::Matx33d(record->rotation); 
+		mRotationCalibrated = true; 
+	}
+	vcharge::CataCameraParameters parameters; 
+	if (getCataParameters(*record, parameters))
+		setUndistortion(parameters); 
+	return true; 
+}
+
+int
+MutualCalibration::addIMUSamples(void * buffer, size_t size, int count)
+{
+	// count records of IMUSample, timestamp and three values in native byte
+	// order, so that the sensor callback can batch them into a direct
+	// ByteBuffer and flush once per frame; returns the number added
+	const char * p = static_cast<const char *>(buffer); 
+	size_t n = std::min(size / sizeof(IMUSample), (size_t)std::max(count, 0)); 
+	for (size_t i = 0; i < n; i++)
+	{
+		// ByteBuffer positions need not be 8 byte aligned
+		IMUSample sample; 
+		memcpy(&sample, p + i * sizeof(IMUSample), sizeof(IMUSample)); 
+		mIMU.push(sample.timestamp, sample.v[0], sample.v[1], sample.v[2]); 
+	}
+	return (int)n; 
+}
+
+bool
+MutualCalibration::addChessboardCorners(void * buffer, size_t size, long long timestamp)
+{
+	StateLock lock(mStateMutex); 
+	// corners found outside, as x y float pairs row by row in native byte
+	// order; goes through the keyframe selection as addChessboardImage
+	size_t n = mBoardSize.area(); 
+	if (size < n * sizeof(cv::Point2f)) return false; 
+	std::vector<cv::Point2f> corners(n); 
+	memcpy(&corners[0], buffer, n * sizeof(cv::Point2f)); 
+
+	mObservationTimestamp = timestamp >= 0 ? timestamp : sessionTimestamp(); 
+	mPendingViews = 0; 
+	if (mKeyframes.isEnabled())
+	{
+		cv::Vec3d gravity; 
+		bool gravityKnown = getObservationGravity(gravity); 
+		if (!mKeyframes.select(corners, mBoardSize, gravityKnown ? &gravity : NULL))
+			return false; 
+	}
+	acceptChessboardCorners(corners, cv::Rect(cv::Point(), mBoardSize)); 
+	return true; 
+}
+
+int
+MutualCalibration::getChessboardCorners(int view, void * buffer, size_t size) const
+{
+	StateLock lock(mStateMutex); 
+	// the corners of a view as addChessboardCorners takes them; returns the
+	// number written
+	if (view < 0 || view >= (int)mImagePoints.size()) return 0; 
+	const std::vector<cv::Point2f> & corners = mImagePoints[view]; 
+	size_t n = std::min(corners.size(), size / sizeof(cv::Point2f)); 
+	if (n > 0) memcpy(buffer, &corners[0], n * sizeof(cv::Point2f)); 
+	return (int)n; 
+}
+
+bool
+MutualCalibration::getCalibrationResults(void * buffer, size_t size) const
+{
+	StateLock lock(mStateMutex); 
+	// getRotationMatrix then getCameraMatrix, as doubles in native byte order
+	if (size < CALIBRATION_RESULTS_SIZE * sizeof(double)) return false; 
+	double p[CALIBRATION_RESULTS_SIZE]; 
+	getRotationMatrix(p); 
+	getCameraMatrix(p + 9); 
+	memcpy(buffer, p, sizeof(p)); 
+	return true; 
+}
+
+bool
+MutualCalibration::getFrameState(void * buffer, size_t size) const
+{
+	StateLock lock(mStateMutex); 
+	// everything the preview shows after a frame, in one call instead of
+	// seven, as doubles in native byte order:
+	// images, online rotation valid, rotation (9), conditioning,
+	// online K valid, K (9), rms, pipeline stats (4)
+	if (size < FRAME_STATE_SIZE * sizeof(double)) return false; 
+	double p[FRAME_STATE_SIZE]; 
+	p[0] = getNumberOfImages(); 
+	p[1] = getOnlineRotationMatrix(p + 2) ? 1.0 : 0.0; 
+	p[11] = getOnlineConditioning(); 
+	if (getOnlineCameraMatrix(p + 13))
+		p[12] = 1.0; 
+	else
+	{
+		p[12] = 0.0; 
+		std::fill(p + 13, p + 22, 0.0); 
+	}
+	p[22] = getOnlineReprojectionError(); 
+	getFramePipelineStats(p + 23); 
+	memcpy(buffer, p, sizeof(p)); 
+	return true; 
+}
+
+bool
+MutualCalibration::startFrameRecording(const char * path)
+{
+	// raw preview frames for benchmarking the detectors offline, see
+	// FrameRecorder.h and main.cpp
+	return mRecorder.open(path, mImageSize, mBoardSize, mUseOnlyIMUGravity); 
+}
+
+void
+MutualCalibration::stopFrameRecording()
+{
+	mRecorder.close(); 
+}
+
+bool
+MutualCalibration::recordNV21Frame(char * nv21, size_t length, int mode, long long timestamp, double s0, double s1, double s2)
+{
+	// only the Y plane is kept, the detectors do not use the chroma
+	if (!checkNV21Length(length)) return false; 
+	double sensor[3] = { s0, s1, s2 }; 
+	return mRecorder.write(timestamp, mode, sensor, reinterpret_cast<const uchar *>(nv21)); 
+}
+
+bool
+MutualCalibration::checkNV21Length(size_t length) const
+{
+	// a preview of another size would be read past its end
+	if (length == (size_t)mImageSize.area() * 3 / 2) return true; 
+	LOGE("MutualCalibration", "NV21 frame of %u bytes, %dx%d expects %u", 
+		 (unsigned)length, mImageSize.width, mImageSize.height, (unsigned)(mImageSize.area() * 3 / 2)); 
+	return false; 
+}
+
+bool
+MutualCalibration::processPipelineFrame(void * context, PipelineFrame & frame)
+{
+	// runs on the pipeline worker, the imu reading is associated the same way
+	// the preview thread does it in the synchronous path
+	MutualCalibration * calibration = static_cast<MutualCalibration *>(context); 
+	StateLock lock(calibration->mStateMutex); 
+	// without samples around the timestamp, the reading enqueued with the
+	// frame is kept; getIMUAtTimestamp logs the miss
+	if (frame.timestamp >= 0 && !calibration->getIMUAtTimestamp(frame.timestamp, frame.sensor))
+		LOGD("MutualCalibration", "frame %u keeps the imu reading passed with it", (unsigned)frame.sequence); 
+
+	cv::Mat gray = frame.image; 
+	if (frame.nv21)
+	{
+		gray = frame.image.rowRange(0, calibration->mImageSize.height); 
+		cv::cvtColor(frame.image, frame.output, CV_YUV2RGBA_NV21); 
+	}
+	bool success = calibration->addImage(gray, frame.mode, frame.overlay, frame.timestamp); 
+	calibration->renderOverlay(frame.overlay, gray, frame.output); 
+
+	if (success)
+	{
+		if (calibration->mUseOnlyIMUGravity)
+			calibration->addIMUGravityVector(frame.sensor[0], frame.sensor[1], frame.sensor[2]); 
+		else
+			calibration->addFullIMURotationByQuaternion(frame.sensor[0], frame.sensor[1], frame.sensor[2]); 
+	}
+	return success; 
 }
 
 void 
 MutualCalibration::calibrateCamera()
 {
+	StateLock lock(mStateMutex); 
 	if (mImagePoints.empty())
 	{
-		float focal = 0;
-		for (size_t i = 0; i < mfsCamera.size(); i++)
-			focal += mfsCamera[i];
-		focal / mfsCamera.size();
-		cv::Mat cameraMatrix(3, 3, CV_64F);
-		cameraMatrix.at<double>(0, 0) = focal;
-		cameraMatrix.at<double>(0, 1) = 0;
-		cameraMatrix.at<double>(0, 2) = (float)mImageSize.width / 2;
-		cameraMatrix.at<double>(1, 0) = 0;
-		cameraMatrix.at<double>(1, 1) = focal;
-		cameraMatrix.at<double>(1, 2) = (float)mImageSize.height / 2;
-		cameraMatrix.at<double>(2, 0) = 0;
-		cameraMatrix.at<double>(2, 1) = 0;
-		cameraMatrix.at<double>(2, 2) = 1;
-		cameraMatrix.copyTo(mKCamera);
+		// the focal length has been estimated online in
+		// tryAddingVanishingPointImage
+		updateCameraMatrixFromFocal(mFocalEstimator.getFocal());
 		return;
 	}
 	
-    std::vector< std::vector<cv::Point3f> > objectPoints;
-    for (int i = 0; i < mImagePoints.size(); ++i)
-    {
-    	std::vector<cv::Point3f> objectPointsInView;
-    	for (int j = 0; j < mBoardSize.height; ++j)
-    	{
-    		for (int k = 0; k < mBoardSize.width; ++k)
-    		{
-    			objectPointsInView.push_back(cv::Point3f(j * mSquareSize, k * mSquareSize, 0.0));
-    		}
-    	}
-    	objectPoints.push_back(objectPointsInView);
-    }
-
 	cv::Mat cameraMatrix, distCoeffs; 
-	std::vector<cv::Mat> rvecs; 
-	if (1)
-	{	
-		cv::calibrateCamera(objectPoints, mImagePoints, mImageSize, cameraMatrix, distCoeffs, rvecs, mtsCamera); 
-		cameraMatrix.copyTo(mKCamera);
-		for (size_t i = 0; i < rvecs.size(); i++)
+	std::vector<cv::Mat> rvecs, tvecs; 
+	std::vector<cv::Mat> objectPoints = createObjectPoints(); 
+	if (mIntrinsics.available())
+	{
+		// the intrinsics have been refined as the views were added, only
+		// the board poses are left
+		cameraMatrix = mIntrinsics.getCameraMatrix(); 
+		distCoeffs = mIntrinsics.getDistortion(); 
+	}
+	else
+	{
+		cv::calibrateCamera(objectPoints, mImagePoints, mImageSize, cameraMatrix, distCoeffs, rvecs, tvecs); 
+	}
+
+	cameraMatrix.copyTo(mKCamera);
+	distCoeffs.copyTo(mDistCamera);
+
+	// the poses and reprojection errors of the views, spread over threads
+	std::vector<ViewResult> views; 
+	mViewRefinement.process(objectPoints, mImagePoints, cameraMatrix, distCoeffs, rvecs, tvecs, views); 
+	const ViewRefinementStats & stats = mViewRefinement.getStats(); 
+	bool excludeOutliers = mViewRefinement.canExcludeOutliers(); 
+	if (stats.outliers > 0 && !excludeOutliers)
+		LOGW("MutualCalibration", "%d of %d views above %.2f px, too few left to exclude them", 
+			 (int)stats.outliers, (int)stats.views, mViewRefinement.getThreshold()); 
+
+	// the views too far off are only marked, mutualCalibrate leaves them out;
+	// every calibration starts again from all the views
+	for (size_t k = 0; k < mViews.size(); k++)
+	{
+		CalibrationView & view = mViews[k]; 
+		if (view.points < 0 || view.points >= (int)views.size()) continue; 
+		view.R = views[view.points].R; 
+		view.rotationKnown = true; 
+		view.excluded = excludeOutliers && views[view.points].outlier; 
+	}
+
+	// the rotations are only known now, rebuild the online estimate
+	mKabsch.reset(); 
+	for (size_t k = 0; k < mViews.size(); k++)
+	{
+		const CalibrationView & view = mViews[k]; 
+		if (view.rotationKnown && view.imuKnown && !view.excluded)
+			mKabsch.add(findCameraGravity(view.R, view.gIMU), view.gIMU); 
+	}
+}
+
+std::vector<cv::Point3f>
+MutualCalibration::createBoardPoints(const cv::Rect & grid) const
+{
+	// row by row, x along grid.width as the corners are returned, at their
+	// place on the whole board
+	std::vector<cv::Point3f> boardPoints;
+	boardPoints.reserve(grid.area()); 
+	for (int j = grid.y; j < grid.y + grid.height; ++j)
+	{
+		for (int k = grid.x; k < grid.x + grid.width; ++k)
 		{
-			cv::Mat RCamera; 
-			cv::Rodrigues(rvecs[i], RCamera); 
-			mRsCamera.push_back(RCamera * 1.0); 
+			boardPoints.push_back(cv::Point3f(k * mSquareSize, j * mSquareSize, 0.0));
 		}
 	}
+	return boardPoints;
 }
 
-cv::Mat
-MutualCalibration::createAlignmentMatrix() const
+std::vector<cv::Mat>
+MutualCalibration::createObjectPoints() const
 {
-	cv::Mat ideal(3, 3, CV_64F);
-	ideal.at<double>(0, 0) = 0;
-	ideal.at<double>(0, 1) = -1;
-	ideal.at<double>(0, 2) = 0;
-	ideal.at<double>(1, 0) = -1;
-	ideal.at<double>(1, 1) = 0;
-	ideal.at<double>(1, 2) = 0;
-	ideal.at<double>(2, 0) = 0;
-	ideal.at<double>(2, 1) = 0;
-	ideal.at<double>(2, 2) = -1;
-	return ideal * 1.0;
+	// one header per view, on the points of mBoardPoints for a whole board
+	// instead of a copy of the board per view
+	std::vector<cv::Mat> objectPoints(mImagePoints.size(), cv::Mat(mBoardPoints)); 
+	for (size_t i = 0; i < mViewGrids.size() && i < objectPoints.size(); i++)
+		if (mViewGrids[i] != cv::Rect(cv::Point(), mBoardSize))
+			objectPoints[i] = cv::Mat(createBoardPoints(mViewGrids[i]), true); 
+	return objectPoints; 
 }
 
-std::vector<cv::Mat>
-MutualCalibration::findCameraGravity(const std::vector<cv::Mat> & cameraRotations, const std::vector<cv::Mat> & imuGravity) const
+void
+MutualCalibration::updateCameraMatrixFromFocal(float focal)
 {
-	cv::Mat ideal = createAlignmentMatrix();
-	std::vector<cv::Mat> cameraGravity;
-	for (size_t i = 0; i < cameraRotations.size(); i++)
+	if (!(focal > 0))
 	{
-		cv::Mat R_c2i = ideal * cameraRotations[i];
+		// no estimate yet: keep the previous camera matrix, or write one
+		// with a zero focal so that getCameraMatrix and saveMatrix in the
+		// activity have a matrix, see cameraMatrixKnown
+		if (!mKCamera.empty()) return; 
+		focal = 0; 
+	}
 
-		cv::Mat gCamera = R_c2i.col(0) * 1.0;
+	cv::Mat cameraMatrix(3, 3, CV_64F);
+	cameraMatrix.at<double>(0, 0) = focal;
+	cameraMatrix.at<double>(0, 1) = 0;
+	cameraMatrix.at<double>(0, 2) = (float)mImageSize.width / 2;
+	cameraMatrix.at<double>(1, 0) = 0;
+	cameraMatrix.at<double>(1, 1) = focal;
+	cameraMatrix.at<double>(1, 2) = (float)mImageSize.height / 2;
+	cameraMatrix.at<double>(2, 0) = 0;
+	cameraMatrix.at<double>(2, 1) = 0;
+	cameraMatrix.at<double>(2, 2) = 1;
+	cameraMatrix.copyTo(mKCamera);
+}
 
-		if (cv::norm(imuGravity[i] + R_c2i.col(0)) < cv::norm(imuGravity[i] - gCamera))
-			gCamera = -R_c2i.col(0) * 1.0;
+bool
+MutualCalibration::cameraMatrixKnown() const
+{
+	// a zero focal marks the matrix of updateCameraMatrixFromFocal
+	// before there is an estimate
+	return !mKCamera.empty() && mKCamera.at<double>(0, 0) > 0; 
+}
 
-		if (cv::norm(imuGravity[i] - R_c2i.col(1)) < cv::norm(imuGravity[i] - gCamera))
-			gCamera = R_c2i.col(1) * 1.0;
+cv::Matx33d
+MutualCalibration::createAlignmentMatrix() const
+{
+	return cv::Matx33d( 0, -1,  0,
+					   -1,  0,  0,
+						0,  0, -1);
+}
 
-		if (cv::norm(imuGravity[i] + R_c2i.col(1)) < cv::norm(imuGravity[i] - gCamera))
-			gCamera = -R_c2i.col(1) * 1.0;
+cv::Vec3d
+MutualCalibration::findCameraGravity(const cv::Matx33d & cameraRotation, const cv::Vec3d & imuGravity) const
+{
+	cv::Matx33d ideal = createAlignmentMatrix();
+	cv::Matx33d R_c2i = ideal * cameraRotation;
 
-		if (cv::norm(imuGravity[i] - R_c2i.col(2)) < cv::norm(imuGravity[i] - gCamera))
-			gCamera = R_c2i.col(2) * 1.0;
+	// the signed column of R_c2i closest to the imu gravity, the first one
+	// wins on ties
+	cv::Vec3d gCamera;
+	double best = -1;
+	for (int j = 0; j < 3; j++)
+	{
+		for (int sign = 1; sign >= -1; sign -= 2)
+		{
+			cv::Vec3d c(sign * R_c2i(0, j), sign * R_c2i(1, j), sign * R_c2i(2, j));
+			double d = cv::norm(imuGravity - c);
+			if (best < 0 || d < best)
+			{
+				gCamera = c;
+				best = d;
+			}
+		}
+	}
 
-		if (cv::norm(imuGravity[i] + R_c2i.col(2)) < cv::norm(imuGravity[i] - gCamera))
-			gCamera = -R_c2i.col(2) * 1.0;
+	return ideal.t() * gCamera;
+}
 
-		cameraGravity.push_back(ideal.t() * gCamera * 1.0);
-	}
+std::vector<cv::Vec3d>
+MutualCalibration::findCameraGravity(const std::vector<cv::Matx33d> & cameraRotations, const std::vector<cv::Vec3d> & imuGravity) const
+{
+	std::vector<cv::Vec3d> cameraGravity;
+	cameraGravity.reserve(cameraRotations.size());
+	for (size_t i = 0; i < cameraRotations.size(); i++)
+		cameraGravity.push_back(findCameraGravity(cameraRotations[i], imuGravity[i]));
 	return cameraGravity;
 
 }
 
 bool
-MutualCalibration::lsMutualCalibrateWithHorizontalChessboard(const std::vector<cv::Mat> & cameraGravity, const std::vector<cv::Mat> & imuGravity, cv::Mat & ouputRotation) const
+MutualCalibration::lsMutualCalibrateWithHorizontalChessboard(const std::vector<cv::Vec3d> & cameraGravity, const std::vector<cv::Vec3d> & imuGravity, cv::Matx33d & ouputRotation) const
 {
-
-	cv::Mat S(3, cameraGravity.size(), CV_64F);
-	cv::Mat T(3, cameraGravity.size(), CV_64F);
+	// Kabsch algorihm from wikipedia, the 3x3 cross-covariance is accumulated
+	// directly instead of stacking the samples into 3xN matrices
+	IncrementalKabsch kabsch;
 	for (size_t i = 0; i < cameraGravity.size(); i++)
-	{
-		S.col(i) = cameraGravity[i] * 1.0;
-		T.col(i) = imuGravity[i] * 1.0;
-	}
+		kabsch.add(cameraGravity[i], imuGravity[i]);
 
-	// Kabsch algorihm from wikipedia
-	cv::Mat A = T * S.t();
-	cv::Mat D, U, Vt;
-	cv::SVD::compute(A, D, U, Vt);
-	cv::Mat R = U * Vt;
-/*	__android_log_print(
-			ANDROID_LOG_INFO, "R", "%lf %lf %lf \n %lf %lf %lf \n %lf %lf %lf\n",
-			R.at<double>(0, 0), R.at<double>(0, 1), R.at<double>(0, 2),
-			R.at<double>(1, 0), R.at<double>(1, 1), R.at<double>(1, 2),
-			R.at<double>(2, 0), R.at<double>(2, 1), R.at<double>(2, 2));*/
-	R.copyTo(ouputRotation);
-	if (D.at<double>(1) / D.at<double>(0) < 0.01) return false;
-	else return true;
+	double conditioning;
+	return kabsch.getRotation(ouputRotation, conditioning);
 }
 
 bool
-MutualCalibration::ransacMutualCalibrateWithHorizontalChessboard(const std::vector<cv::Mat> & cameraGravity, const std::vector<cv::Mat> & imuGravity, cv::Mat & outputRotation) const
+MutualCalibration::triadRotation(const cv::Vec3d & s1, const cv::Vec3d & s2, const cv::Vec3d & t1, const cv::Vec3d & t2, cv::Matx33d & outputRotation) const
 {
-	// RANSAC
-	size_t it = 0;
-	size_t max_iter = 100;
-	cv::Mat R_best;
-	size_t max_inliers = 0;
+	// TRIAD: two non-parallel pairs fix the rotation exactly. Both pairs are
+	// turned into orthonormal frames, the first axis along the first vector,
+	// and R maps one frame onto the other.
+	cv::Vec3d sn = s1.cross(s2);
+	cv::Vec3d tn = t1.cross(t2);
+	if (cv::norm(sn) < 1e-3 || cv::norm(tn) < 1e-3) return false;
 
-	while (it < max_iter)
-	{
-		std::vector<size_t> perm = randPerm(mRsCamera.size());
+	cv::Vec3d sa = cv::normalize(s1), sb = cv::normalize(sn), sc = sa.cross(sb);
+	cv::Vec3d ta = cv::normalize(t1), tb = cv::normalize(tn), tc = ta.cross(tb);
+	for (int i = 0; i < 3; i++)
+		for (int j = 0; j < 3; j++)
+			outputRotation(i, j) = ta[i] * sa[j] + tb[i] * sb[j] + tc[i] * sc[j];
+	return true;
+}
 
-		std::vector<cv::Mat> sampledCameraGravity, sampledImuGravity;
-		for (size_t i = 0; i < 3; i++)
-		{
-			sampledCameraGravity.push_back(cameraGravity[perm[i]]);
-			sampledImuGravity.push_back(imuGravity[perm[i]]);
-		}
+bool
+MutualCalibration::ransacMutualCalibrateWithHorizontalChessboard(const std::vector<cv::Vec3d> & cameraGravity, const std::vector<cv::Vec3d> & imuGravity, cv::Matx33d & outputRotation, RotationRansacStats & stats) const
+{
+	// RANSAC with the minimal two-sample solver; the number of iterations
+	// follows the best inlier ratio so far, max_iter only bounds it
+	int64 start = cv::getTickCount();
+	const size_t n = cameraGravity.size();
+	const size_t max_iter = 100;
+	const double confidence = 0.99;
+	const double threshold = 0.05;
 
-		cv::Mat R;
-		bool wellPosed = lsMutualCalibrateWithHorizontalChessboard(sampledCameraGravity, sampledImuGravity, R);
-		if (!wellPosed) continue;
+	stats = RotationRansacStats();
+	stats.samples = n;
 
-		cv::Mat U(3, cameraGravity.size(), CV_64F);
-		for (size_t i = 0; i < cameraGravity.size(); i++)
-			U.col(i) = cameraGravity[i] * 1.0;
+	size_t needed = max_iter;
+	size_t max_inliers = 0;
+	cv::Matx33d R_best;
+	while (n >= 2 && stats.iterations < needed)
+	{
+		stats.iterations++;
+
+		size_t i1 = rand() % n;
+		size_t i2 = rand() % (n - 1);
+		if (i2 >= i1) i2++;
+
+		// degenerate draws count as iterations, so that a data set of
+		// parallel directions cannot keep the loop going
+		cv::Matx33d R;
+		if (!triadRotation(cameraGravity[i1], cameraGravity[i2], imuGravity[i1], imuGravity[i2], R)) continue;
 
-		cv::Mat V = R * U;
 		size_t inliers = 0;
-		for (size_t i = 0; i < V.cols; i++)
-		{
-			__android_log_print(
-							ANDROID_LOG_INFO, "R_err", "%lf", cv::norm(V.col(i) - imuGravity[i]));
-			if (cv::norm(V.col(i) - imuGravity[i]) < 0.05) inliers++;
-		}
+		for (size_t i = 0; i < n; i++)
+			if (cv::norm(R * cameraGravity[i] - imuGravity[i]) < threshold) inliers++;
+
 		if (inliers > max_inliers)
 		{
-			R.copyTo(R_best);
+			R_best = R;
 			max_inliers = inliers;
-		}
-		it++;
-
-		__android_log_print(
-				ANDROID_LOG_INFO, "R", "%lf %lf %lf \n %lf %lf %lf \n %lf %lf %lf\n %d %d",
-				R.at<double>(0, 0), R.at<double>(0, 1), R.at<double>(0, 2),
-				R.at<double>(1, 0), R.at<double>(1, 1), R.at<double>(1, 2),
-				R.at<double>(2, 0), R.at<double>(2, 1), R.at<double>(2, 2), inliers, it);
 
+			// probability that both samples are inliers
+			double w = (double)inliers / n;
+			double p = w * w;
+			if (p >= 1.0) needed = stats.iterations;
+			else
+				needed = std::min(max_iter, (size_t)ceil(log(1.0 - confidence) / log(1.0 - p)));
+		}
 	}
 
-	if (max_inliers > 0)
+	// least-squares refit on the consensus set
+	bool wellPosed = false;
+	if (max_inliers >= 3)
 	{
-		__android_log_print(
-			ANDROID_LOG_INFO, "R_best", "%lf %lf %lf \n %lf %lf %lf \n %lf %lf %lf\n %d",
-			R_best.at<double>(0, 0), R_best.at<double>(0, 1), R_best.at<double>(0, 2),
-			R_best.at<double>(1, 0), R_best.at<double>(1, 1), R_best.at<double>(1, 2),
-			R_best.at<double>(2, 0), R_best.at<double>(2, 1), R_best.at<double>(2, 2), max_inliers);
-
-		R_best.copyTo(outputRotation);
+		std::vector<cv::Vec3d> inlierCameraGravity, inlierImuGravity;
+		for (size_t i = 0; i < n; i++)
+		{
+			if (cv::norm(R_best * cameraGravity[i] - imuGravity[i]) < threshold)
+			{
+				inlierCameraGravity.push_back(cameraGravity[i]);
+				inlierImuGravity.push_back(imuGravity[i]);
+			}
+		}
+		wellPosed = lsMutualCalibrateWithHorizontalChessboard(inlierCameraGravity, inlierImuGravity, outputRotation);
 	}
-	else
-		__android_log_print(
-			ANDROID_LOG_INFO, "R_best", "Weird");
-
+	stats.inliers = max_inliers;
+	stats.milliseconds = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
 
-	return max_inliers >= 3;
+	return wellPosed;
 
 }
 
 bool
 MutualCalibration::mutualCalibrate()
 {
-	std::vector<cv::Mat> cameraGravity = findCameraGravity(mRsCamera, mgsIMU);
+	StateLock lock(mStateMutex); 
+	// the online estimate is the least-squares solution over the same pairs,
+	// RANSAC needs the pairs themselves
+	if (mUseIncrementalCalibration && !mUseRANSAC)
+	{
+		double conditioning;
+		mRotationCalibrated = mKabsch.getRotation(mCamera2IMU, conditioning);
+		return mRotationCalibrated;
+	}
+
+	std::vector<cv::Matx33d> rsCamera; 
+	std::vector<cv::Vec3d> gsIMU; 
+	for (size_t k = 0; k < mViews.size(); k++)
+	{
+		const CalibrationView & view = mViews[k]; 
+		if (!view.rotationKnown || !view.imuKnown || view.excluded) continue; 
+		rsCamera.push_back(view.R); 
+		gsIMU.push_back(view.gIMU); 
+	}
+	std::vector<cv::Vec3d> cameraGravity = findCameraGravity(rsCamera, gsIMU);
 	bool wellPosed;
 	if (mUseRANSAC)
 	{
-		wellPosed = ransacMutualCalibrateWithHorizontalChessboard(cameraGravity, mgsIMU, mCamera2IMU);
+		wellPosed = ransacMutualCalibrateWithHorizontalChessboard(cameraGravity, gsIMU, mCamera2IMU, mRansacStats);
 	}
 	else
 	{
-		wellPosed = lsMutualCalibrateWithHorizontalChessboard(cameraGravity, mgsIMU, mCamera2IMU);
+		wellPosed = lsMutualCalibrateWithHorizontalChessboard(cameraGravity, gsIMU, mCamera2IMU);
 	}
 
+	mRotationCalibrated = wellPosed; 
 	return wellPosed;
 }
@@ -1,28 +1,78 @@
 #include <iostream>
 #include <vector>
-#include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/calib3d/calib3d.hpp>
 //#include <boost/math/quaternion.hpp>
 
 #include "CataCameraParameters.h"
 #include "Chessboard.h"
+#include "FramePipeline.h"
+#include "FrameRecorder.h"
+#include "IMUHistory.h"
+#include "IncrementalIntrinsics.h"
+#include "IncrementalKabsch.h"
+#include "KeyframeSelector.h"
+#include "OnlineFocalEstimator.h"
+#include "Overlay.h"
+#include "SessionLog.h"
+#include "UndistortionMap.h"
+#include "VanishingPointEngine.h"
+#include "VanishingPointTracker.h"
+#include "ViewRefinement.h"
+
+// One accepted view. The camera rotation and the imu reading are paired
+// through it, whatever order the images and readings come in, and a view
+// that calibrateCamera finds off is only marked, so that a later calibration
+// with another threshold can use it again.
+struct CalibrationView
+{
+	CalibrationView() : points(-1), rotationKnown(false), imuKnown(false), excluded(false) {}
+
+	int points;							// index in mImagePoints for a chessboard view, -1 for vanishing points
+	cv::Matx33d R;						// camera rotation, from the vanishing points or the board pose
+	bool rotationKnown; 
+	cv::Vec3d gIMU;						// gravity in the imu frame
+	bool imuKnown; 
+	bool excluded;						// reprojection outlier in the last calibrateCamera
+}; 
+
+struct RotationRansacStats
+{
+	size_t samples; 
+	size_t iterations; 
+	size_t inliers; 
+	double milliseconds; 
+
+	RotationRansacStats() : samples(0), iterations(0), inliers(0), milliseconds(0) {}
+}; 
 
 class MutualCalibration
 {
 	cv::Size mImageSize; 
 	cv::Size mBoardSize; 
 	float mSquareSize; 
+	// corner positions on the board, in the order the detectors return them;
+	// the same for every view, so built once and shared
+	std::vector<cv::Point3f> mBoardPoints; 
 //	std::vector<cv::Mat> mChessboardImages; 
 	std::vector<std::vector<cv::Point2f> > mImagePoints; 
+	// the corners of each view in the board, as first column and row and
+	// grid size; the whole board unless it was partly hidden
+	std::vector<cv::Rect> mViewGrids; 
 	
-//	vcharge::CataCameraParameters mCameraParam;
+	// from the CataCameraParameters of the camera, if known; the vanishing
+	// point engines then work on undistorted line endpoints
+	UndistortionMapPtr mUndistortion; 
 	cv::Mat mKCamera;
-	std::vector<cv::Mat> mRsCamera, mtsCamera; //, mgsCamera;
-	std::vector<float> mfsCamera; 
-	std::vector<cv::Mat> mgsIMU; //mRsIMU,
+	cv::Mat mDistCamera;
+	// in the order they were accepted; fixed-size members, so that the
+	// vector holds them contiguously
+	std::vector<CalibrationView> mViews; 
+	OnlineFocalEstimator mFocalEstimator; 
 
-	cv::Mat mCamera2IMU; 
+	cv::Matx33d mCamera2IMU; 
+	bool mRotationCalibrated;			// mCamera2IMU is from a well posed mutualCalibrate or a loaded file
+	RotationRansacStats mRansacStats; 
 
 	bool mUseOpenCVCorner; 
 	bool mUseOpenCVCalibration; 
@@ -35,6 +85,49 @@ class MutualCalibration
 
 	size_t mChessboardImages, mVanishingPointImages; 
 
+	VanishingPointTracker mTracker; 
+
+	VanishingPointEngineSet mEngines; 
+
+	bool mDrawOverlay; 
+	Overlay mOverlay; 
+
+	IMUHistory mIMU; 
+
+	bool mUseIncrementalCalibration; 
+	IncrementalKabsch mKabsch; 
+	// the last views, accepted since the last imu reading; several for a
+	// frame with more than one board
+	size_t mPendingViews; 
+
+	SessionLogWriter mSessionLog; 
+	int64 mObservationTimestamp; 
+
+	FrameRecorder mRecorder; 
+
+	KeyframeSelector mKeyframes; 
+
+	size_t mBoardsPerFrame; 
+	// mBoardSize, then the sizes of other boards that may be in view
+	std::vector<cv::Size> mBoardSizes; 
+	bool mUsePartialBoards; 
+
+	IncrementalIntrinsics mIntrinsics; 
+
+	ViewRefinement mViewRefinement; 
+
+	// recursive, held by the pipeline worker for a whole frame and by every
+	// public method that reads or changes the calibration state; the imu
+	// ring buffer, the session log and the pipeline handle their own threads
+	mutable pthread_mutex_t mStateMutex; 
+	// guards mOverlay alone, taken after mStateMutex when both are held, so
+	// that the last overlay can be read while the worker holds the state
+	mutable pthread_mutex_t mOverlayMutex; 
+
+	// declared last, so that the worker is stopped before anything it uses
+	// is destroyed
+	FramePipeline mPipeline; 
+
 protected:
 
 public:
@@ -43,19 +136,92 @@ public:
 					  bool useOpenCVCorner = false,
 					  bool useOnlyIMUGravity = false,
 					  bool useRANSAC = false);
+	~MutualCalibration(); 
 	bool tryAddingChessboardImage(cv::Mat & inputImage, cv::Mat & outputImage); 
 	bool tryAddingVanishingPointImage(cv::Mat & inputImage, cv::Mat & outputImage); 
+	bool tryAddingNV21Image(char * nv21, size_t length, int mode, cv::Mat & outputImage); 
+	void setOverlayDrawing(bool enable); 
+	size_t getOverlaySize() const; 
+	void getOverlay(float p[]) const; 
 	void addFullIMURotationByQuaternion(double r0, double r1, double r2); 
 	void addIMUGravityVector(double g1, double g2, double g3); 
+	void addIMUSample(long long timestamp, double x, double y, double z); 
+	void setIMUTimeConstant(double seconds); 
+	bool getIMUAtTimestamp(long long timestamp, double p[]) const; 
+	void setVanishingPointTracking(bool enable); 
+	void setIMURotationDelta(double r0, double r1, double r2); 
+	void setVanishingPointEngine(int engine); 
+	void setParallelVanishingPointEngines(bool enable); 
+	void getVanishingPointStats(double p[]) const; 
+	bool setCameraParameters(int width, int height, double xi, double k1, double k2, double p1, double p2, 
+							 double gamma1, double gamma2, double u0, double v0); 
+	bool loadCameraParameters(const char * path); 
+	void setLogLevel(int level); 
+	bool startFramePipeline(); 
+	void stopFramePipeline(); 
+	bool enqueueFrame(cv::Mat & inputImage, cv::Mat & outputImage, int mode, double s0, double s1, double s2); 
+	bool enqueueNV21Frame(char * nv21, size_t length, int mode, double s0, double s1, double s2); 
+	bool enqueueTimedNV21Frame(char * nv21, size_t length, int mode, long long timestamp, double s0, double s1, double s2); 
+	int pollFrameResult(cv::Mat & outputImage); 
+	void getFramePipelineStats(double p[]) const; 
+	void setSquareSize(float size); 
+	void setBoardsPerFrame(int boards); 
+	void addBoardSize(int heightBoard, int widthBoard); 
+	void setPartialBoards(bool enable); 
+	void setKeyframeSelection(bool enable); 
+	void getKeyframeStats(double p[]) const; 
+	void setIncrementalIntrinsics(bool enable); 
+	bool getOnlineCameraMatrix(double p[]) const; 
+	double getOnlineReprojectionError() const; 
+	void setViewErrorThreshold(double pixels); 
+	void getViewRefinementStats(double p[]) const; 
+	bool startSessionLog(const char * path); 
+	void stopSessionLog(); 
+	bool replaySession(const char * path); 
+	bool saveCalibration(const char * path) const; 
+	bool loadCalibration(const char * path); 
+	// batched transfers through direct ByteBuffers, native byte order
+	int addIMUSamples(void * buffer, size_t size, int count); 
+	bool addChessboardCorners(void * buffer, size_t size, long long timestamp); 
+	int getChessboardCorners(int view, void * buffer, size_t size) const; 
+	bool getCalibrationResults(void * buffer, size_t size) const; 
+	bool getFrameState(void * buffer, size_t size) const; 
+	bool startFrameRecording(const char * path); 
+	void stopFrameRecording(); 
+	bool recordNV21Frame(char * nv21, size_t length, int mode, long long timestamp, double s0, double s1, double s2); 
 	size_t getNumberOfImages() const; 
+	double getFocalConfidence() const; 
 	void getRotationMatrix(double p[]) const; 
+	void setIncrementalCalibration(bool enable); 
+	bool getOnlineRotationMatrix(double p[]) const; 
+	double getOnlineConditioning() const; 
 	void getCameraMatrix(double p[]) const;
+	void getRansacStats(double p[]) const;
 	void calibrateCamera();
 	bool mutualCalibrate();
 protected:
-	std::vector<size_t> randPerm(size_t n) const;
-	cv::Mat createAlignmentMatrix() const;
-	std::vector<cv::Mat> findCameraGravity(const std::vector<cv::Mat> & cameraRotations, const std::vector<cv::Mat> & imuGravity) const;
-	bool lsMutualCalibrateWithHorizontalChessboard(const std::vector<cv::Mat> & cameraGravity, const std::vector<cv::Mat> & imuGravity, cv::Mat & outputRotation) const;
-	bool ransacMutualCalibrateWithHorizontalChessboard(const std::vector<cv::Mat> & cameraGravity, const std::vector<cv::Mat> & imuGravity, cv::Mat & outputRotation) const;
+	cv::Matx33d createAlignmentMatrix() const;
+	cv::Mat rotationFromQuaternion(double r0, double r1, double r2) const;
+	void updateCameraMatrixFromFocal(float focal);
+	bool cameraMatrixKnown() const; 
+	bool setUndistortion(const vcharge::CataCameraParameters & parameters); 
+	bool addImage(const cv::Mat & image, int mode, Overlay & overlay, int64 timestamp = -1);
+	bool addChessboardImage(const cv::Mat & image, Overlay & overlay);
+	bool addVanishingPointImage(const cv::Mat & image, Overlay & overlay);
+	void acceptChessboardCorners(const std::vector<cv::Point2f> & corners, const cv::Rect & grid);
+	bool getObservationGravity(cv::Vec3d & gravity) const;
+	void acceptVanishingPoint(const cv::Mat & rotation, float focal);
+	void renderOverlay(const Overlay & overlay, const cv::Mat & image, cv::Mat & outputImage) const;
+	void storeOverlay(const Overlay & overlay);
+	bool checkNV21Length(size_t length) const;
+	bool checkSessionRecord(const SessionRecord & record) const;
+	static bool processPipelineFrame(void * context, PipelineFrame & frame);
+	std::vector<cv::Point3f> createBoardPoints(const cv::Rect & grid) const;
+	std::vector<cv::Mat> createObjectPoints() const;
+	void addPendingIMUReading(const cv::Vec3d & gravity);
+	cv::Vec3d findCameraGravity(const cv::Matx33d & cameraRotation, const cv::Vec3d & imuGravity) const;
+	std::vector<cv::Vec3d> findCameraGravity(const std::vector<cv::Matx33d> & cameraRotations, const std::vector<cv::Vec3d> & imuGravity) const;
+	bool lsMutualCalibrateWithHorizontalChessboard(const std::vector<cv::Vec3d> & cameraGravity, const std::vector<cv::Vec3d> & imuGravity, cv::Matx33d & outputRotation) const;
+	bool triadRotation(const cv::Vec3d & s1, const cv::Vec3d & s2, const cv::Vec3d & t1, const cv::Vec3d & t2, cv::Matx33d & outputRotation) const;
+	bool ransacMutualCalibrateWithHorizontalChessboard(const std::vector<cv::Vec3d> & cameraGravity, const std::vector<cv::Vec3d> & imuGravity, cv::Matx33d & outputRotation, RotationRansacStats & stats) const;
 }; 
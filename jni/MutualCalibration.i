@@ -5,5 +5,32 @@
 #include "MutualCalibration.h"
 %}
 %include "arrays_java.i"
+%include "various.i"
+/* preview frames are passed as byte[] with their length, read only */
+%typemap(jni) (char * nv21, size_t length) "jbyteArray"
+%typemap(jtype) (char * nv21, size_t length) "byte[]"
+%typemap(jstype) (char * nv21, size_t length) "byte[]"
+%typemap(javain) (char * nv21, size_t length) "$javainput"
+%typemap(in) (char * nv21, size_t length) {
+  $1 = (char *) jenv->GetByteArrayElements($input, 0);
+  if (!$1) return $null;
+  $2 = (size_t) jenv->GetArrayLength($input);
+}
+%typemap(freearg) (char * nv21, size_t length) {
+  jenv->ReleaseByteArrayElements($input, (jbyte *) $1, JNI_ABORT);
+}
+/* batches are passed as direct ByteBuffers, used in place */
+%typemap(jni) (void * buffer, size_t size) "jobject"
+%typemap(jtype) (void * buffer, size_t size) "java.nio.ByteBuffer"
+%typemap(jstype) (void * buffer, size_t size) "java.nio.ByteBuffer"
+%typemap(javain) (void * buffer, size_t size) "$javainput"
+%typemap(in) (void * buffer, size_t size) {
+  $1 = jenv->GetDirectBufferAddress($input);
+  if (!$1) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaIllegalArgumentException, "direct ByteBuffer expected");
+    return $null;
+  }
+  $2 = (size_t) jenv->GetDirectBufferCapacity($input);
+}
 /* Let's just grab the original header file here */
 %include "MutualCalibration.h"
\ No newline at end of file
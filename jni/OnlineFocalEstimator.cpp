@@ -0,0 +1,151 @@
+#include "OnlineFocalEstimator.h"
+
+#include <cmath>
+#include <algorithm>
+
+OnlineFocalEstimator::OnlineFocalEstimator(double maxRelativeError)
+	: mMaxRelativeError(maxRelativeError)
+{
+	reset(); 
+}
+
+void
+OnlineFocalEstimator::reset()
+{
+	mSamples = 0; 
+	mRejected = 0; 
+	mConsecutiveRejected = 0; 
+	mLocation = 0.0; 
+	mScale = 0.0; 
+	mAbsDeviation = 0.0; 
+	mWeight = 0.0; 
+}
+
+bool
+OnlineFocalEstimator::update(float focal)
+{
+	if (!(focal > 0)) 
+	{
+		mRejected++; 
+		return false; 
+	}
+
+	if (mSamples < WARMUP)
+	{
+		mWarmup[mSamples++] = focal; 
+		if (mSamples == WARMUP) initialize(); 
+		return true; 
+	}
+
+	// Huber weight with a 1.5 sigma threshold, reject beyond 5 sigma
+	double r = focal - mLocation; 
+	double c = 1.5 * mScale; 
+	double eta = 1.0 / std::min<double>(mSamples + 1, 50); 
+	if (fabs(r) > 5.0 * mScale) 
+	{
+		mRejected++; 
+		// outliers widen the scale too, or a scale that started too small
+		// would reject everything after it
+		updateScale(eta, 5.0 * mScale); 
+		mWarmup[mConsecutiveRejected++] = focal; 
+		if (mConsecutiveRejected == WARMUP) 
+		{
+			// the estimate has drifted away from the data, start over from
+			// the rejected samples, which initialize() judges again
+			mRejected -= WARMUP; 
+			mSamples += WARMUP; 
+			initialize(); 
+			mConsecutiveRejected = 0; 
+		}
+		return false; 
+	}
+	mConsecutiveRejected = 0; 
+	double w = fabs(r) <= c ? 1.0 : c / fabs(r); 
+
+	mWeight += w; 
+	mLocation += w * r / mWeight; 
+	updateScale(eta, fabs(r)); 
+
+	mSamples++; 
+	return true; 
+}
+
+void
+OnlineFocalEstimator::initialize()
+{
+	float sorted[WARMUP]; 
+	std::copy(mWarmup, mWarmup + WARMUP, sorted); 
+	std::sort(sorted, sorted + WARMUP); 
+	mLocation = sorted[WARMUP / 2]; 
+
+	for (size_t i = 0; i < WARMUP; i++)
+		sorted[i] = fabs(mWarmup[i] - mLocation); 
+	std::sort(sorted, sorted + WARMUP); 
+	mScale = std::max(1.4826 * sorted[WARMUP / 2], 1e-3 * mLocation); 
+	mAbsDeviation = mScale / 1.2533; 
+
+	// the warm-up samples within 3 sigma count as inliers
+	mWeight = 0.0; 
+	for (size_t i = 0; i < WARMUP; i++)
+	{
+		if (fabs(mWarmup[i] - mLocation) <= 3.0 * mScale) mWeight += 1.0; 
+		else mRejected++; 
+	}
+}
+
+void
+OnlineFocalEstimator::updateScale(double eta, double deviation)
+{
+	// running mean absolute deviation, sqrt(pi / 2) times it is sigma for
+	// normally distributed measurements
+	mAbsDeviation += eta * (deviation - mAbsDeviation); 
+	mScale = std::max(1.2533 * mAbsDeviation, 1e-3 * mLocation); 
+}
+
+bool
+OnlineFocalEstimator::available() const
+{
+	return mSamples > 0; 
+}
+
+float
+OnlineFocalEstimator::getFocal() const
+{
+	if (mSamples == 0) return -1.0f; 
+	if (mSamples < WARMUP)
+	{
+		// median of the samples seen so far
+		float sorted[WARMUP]; 
+		std::copy(mWarmup, mWarmup + mSamples, sorted); 
+		std::sort(sorted, sorted + mSamples); 
+		return sorted[mSamples / 2]; 
+	}
+	return mLocation; 
+}
+
+double
+OnlineFocalEstimator::getRelativeError() const
+{
+	if (mSamples < WARMUP || mWeight <= 0 || mLocation <= 0) return 1.0; 
+	return mScale / (mLocation * sqrt(mWeight)); 
+}
+
+double
+OnlineFocalEstimator::getConfidence() const
+{
+	// 1 for a perfectly determined focal length, 0 once the relative standard
+	// error reaches mMaxRelativeError
+	return std::max(0.0, 1.0 - getRelativeError() / mMaxRelativeError); 
+}
+
+size_t
+OnlineFocalEstimator::getNumberOfSamples() const
+{
+	return mSamples; 
+}
+
+size_t
+OnlineFocalEstimator::getNumberOfRejected() const
+{
+	return mRejected; 
+}
@@ -0,0 +1,46 @@
+#ifndef ONLINEFOCALESTIMATOR_H
+#define ONLINEFOCALESTIMATOR_H
+
+#include <cstddef>
+
+// Robust running estimate of the focal length from per-image measurements.
+// Memory is constant: a few samples are buffered to initialise location and
+// scale from their median, afterwards every update is a Huber-weighted
+// recursive mean and gross outliers are rejected. The scale follows the mean
+// absolute deviation, rejected samples included up to the rejection bound,
+// and a run of consecutive rejections re-initialises from those samples, so
+// that a bad start is not kept forever.
+class OnlineFocalEstimator
+{
+	static const size_t WARMUP = 5; 
+
+	float mWarmup[WARMUP];				// warm-up samples, then consecutive rejections
+	size_t mSamples; 
+	size_t mRejected; 
+	size_t mConsecutiveRejected; 
+
+	double mLocation; 
+	double mScale; 
+	double mAbsDeviation; 
+	double mWeight; 
+	double mMaxRelativeError; 
+
+public: 
+	OnlineFocalEstimator(double maxRelativeError = 0.05); 
+
+	bool update(float focal); 
+	void reset(); 
+
+	bool available() const; 
+	float getFocal() const; 
+	double getRelativeError() const; 
+	double getConfidence() const; 
+	size_t getNumberOfSamples() const; 
+	size_t getNumberOfRejected() const; 
+
+protected:
+	void initialize(); 
+	void updateScale(double eta, double deviation); 
+}; 
+
+#endif
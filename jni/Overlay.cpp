@@ -0,0 +1,101 @@
+#include "Overlay.h"
+
+#include <algorithm>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+void
+Overlay::clear()
+{
+	mPoints.clear(); 
+	mSegments.clear(); 
+}
+
+bool
+Overlay::empty() const
+{
+	return mPoints.empty() && mSegments.empty(); 
+}
+
+void
+Overlay::addPoint(const cv::Point2f & pt, const cv::Scalar & colour, float radius)
+{
+	OverlayPoint p; 
+	p.pt = pt; 
+	p.colour = colour; 
+	p.radius = radius; 
+	mPoints.push_back(p); 
+}
+
+void
+Overlay::addSegment(const cv::Point2f & from, const cv::Point2f & to, const cv::Scalar & colour, float thickness)
+{
+	OverlaySegment s; 
+	s.from = from; 
+	s.to = to; 
+	s.colour = colour; 
+	s.thickness = thickness; 
+	mSegments.push_back(s); 
+}
+
+const std::vector<OverlayPoint> &
+Overlay::getPoints() const
+{
+	return mPoints; 
+}
+
+const std::vector<OverlaySegment> &
+Overlay::getSegments() const
+{
+	return mSegments; 
+}
+
+void
+Overlay::draw(cv::Mat & image) const
+{
+	for (size_t i = 0; i < mSegments.size(); i++)
+	{
+		const OverlaySegment & s = mSegments[i]; 
+		cv::line(image, s.from, s.to, s.colour, std::max(1, cvRound(s.thickness)), 8); 
+	}
+	for (size_t i = 0; i < mPoints.size(); i++)
+	{
+		const OverlayPoint & p = mPoints[i]; 
+		cv::circle(image, p.pt, std::max(1, cvRound(p.radius)), p.colour, 1, 8); 
+	}
+}
+
+size_t
+Overlay::getPackedSize() const
+{
+	return 2 + 6 * mPoints.size() + 8 * mSegments.size(); 
+}
+
+void
+Overlay::pack(float * p) const
+{
+	*p++ = mPoints.size(); 
+	*p++ = mSegments.size(); 
+	for (size_t i = 0; i < mPoints.size(); i++)
+	{
+		const OverlayPoint & q = mPoints[i]; 
+		*p++ = q.pt.x; 
+		*p++ = q.pt.y; 
+		*p++ = q.colour[2]; 
+		*p++ = q.colour[1]; 
+		*p++ = q.colour[0]; 
+		*p++ = q.radius; 
+	}
+	for (size_t i = 0; i < mSegments.size(); i++)
+	{
+		const OverlaySegment & s = mSegments[i]; 
+		*p++ = s.from.x; 
+		*p++ = s.from.y; 
+		*p++ = s.to.x; 
+		*p++ = s.to.y; 
+		*p++ = s.colour[2]; 
+		*p++ = s.colour[1]; 
+		*p++ = s.colour[0]; 
+		*p++ = s.thickness; 
+	}
+}
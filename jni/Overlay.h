@@ -0,0 +1,46 @@
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+struct OverlayPoint
+{
+	cv::Point2f pt; 
+	cv::Scalar colour;					// bgr, as drawn by OpenCV
+	float radius; 
+}; 
+
+struct OverlaySegment
+{
+	cv::Point2f from, to; 
+	cv::Scalar colour; 
+	float thickness; 
+}; 
+
+// Detections as drawing primitives in image coordinates, so that they can be
+// drawn by the UI directly on its preview instead of on a copy of the frame.
+class Overlay
+{
+	std::vector<OverlayPoint> mPoints; 
+	std::vector<OverlaySegment> mSegments; 
+
+public: 
+	void clear(); 
+	bool empty() const; 
+
+	void addPoint(const cv::Point2f & pt, const cv::Scalar & colour, float radius); 
+	void addSegment(const cv::Point2f & from, const cv::Point2f & to, const cv::Scalar & colour, float thickness); 
+
+	const std::vector<OverlayPoint> & getPoints() const; 
+	const std::vector<OverlaySegment> & getSegments() const; 
+
+	void draw(cv::Mat & image) const; 
+
+	// flat layout: number of points, number of segments, then x y r g b
+	// radius per point and x0 y0 x1 y1 r g b thickness per segment
+	size_t getPackedSize() const; 
+	void pack(float * p) const; 
+}; 
+
+#endif
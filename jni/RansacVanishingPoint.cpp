@@ -3,12 +3,16 @@
 #include <cmath>
 #include <utility>
 #include <algorithm>
-#include <iostream>
 #include <opencv2/imgproc/imgproc.hpp>
+
+#include "Log.h"
+#if LOG_SHOW_IMAGES
 #include <opencv2/highgui/highgui.hpp>
-#include <android/log.h>
+#endif
 
-RansacVanishingPoint::RansacVanishingPoint(const cv::Mat & image, cv::Point2f pp, float focal)
+RansacVanishingPoint::RansacVanishingPoint(const cv::Mat & image, cv::Point2f pp, float focal, 
+										   const UndistortionMap * undistortion, cv::RNG * rng)
+	: mRng(rng ? rng : &cv::theRNG())
 {
 
 	if (pp.x > 0 && pp.y > 0)
@@ -28,9 +32,10 @@ RansacVanishingPoint::RansacVanishingPoint(const cv::Mat & image, cv::Point2f pp
 	if (image.channels() > 1)	
 		cv::cvtColor(image, mImage, CV_BGR2GRAY); 
 	else image.copyTo(mImage); 
-	cv::cvtColor(mImage, mSketch, CV_GRAY2BGR); 
 
 	detectLines(); 
+	// only the endpoints are undistorted, through the table
+	if (undistortion) undistortion->undistortLines(mLines); 
 	for (size_t i = 0; i < mLines.size(); i++)
 	{
 		mLines[i][0] -= mImage.cols / 2; 
@@ -50,6 +55,7 @@ RansacVanishingPoint::findVanishingPts()
 	size_t max_count = 5; 
 	std::vector<cv::Vec4i> lines(mLines); 
 	mVanishingPts.clear(); 
+	mPairStats = LinePairStats(); 
 	for (size_t i = 0; i < max_count; i++)
 	{
 		cv::Point2f vpt = ransac2Lines(lines); 
@@ -75,7 +81,65 @@ RansacVanishingPoint::findOrthogonalVanishingPts()
 		float err; 
 		selectOrthogonalVanishingPtsHelper(mOrthogonalVanishingPts, mFocal, err); 
 	}
-	std::cout << mFocal << std::endl; 
+	LOGD("RansacVanishingPoint", "focal %f", mFocal); 
+}
+
+bool
+RansacVanishingPoint::trackOrthogonalVanishingPts(const cv::Mat & rotation, float focal)
+{
+	// Predict the three vanishing points from a previous Manhattan frame and
+	// focal length, associate every line to its closest prediction in a single
+	// pass and re-estimate each point from its inliers. Returns false when the
+	// prediction is not supported anymore, so that the caller can fall back to
+	// findOrthogonalVanishingPts().
+	size_t min_support = 5; 
+	float gate = 6.0f; 
+	mPairStats = LinePairStats(); 
+	if (rotation.empty() || focal <= 0) return false; 
+
+	std::vector<cv::Point2f> predicted; 
+	for (size_t i = 0; i < 3; i++)
+	{
+		double x = rotation.at<double>(0, i); 
+		double y = rotation.at<double>(1, i); 
+		double z = rotation.at<double>(2, i); 
+		if (fabs(z) < 1e-6) z = z < 0 ? -1e-6 : 1e-6; 
+		predicted.push_back(cv::Point2f(x / z * focal, y / z * focal)); 
+	}
+
+	std::vector<std::vector<cv::Vec4i> > support(3); 
+	for (size_t i = 0; i < mLines.size(); i++)
+	{
+		size_t best = 0; 
+		float best_dist = std::numeric_limits<float>::max(); 
+		for (size_t j = 0; j < 3; j++)
+		{
+			float d = distance(predicted[j], mLines[i]); 
+			if (d < best_dist)
+			{
+				best_dist = d; 
+				best = j; 
+			}
+		}
+		if (best_dist < gate) support[best].push_back(mLines[i]); 
+	}
+
+	std::vector<cv::Point2f> vpts; 
+	for (size_t j = 0; j < 3; j++)
+	{
+		if (support[j].size() < min_support) return false; 
+		vpts.push_back(intersectLines(support[j])); 
+		if (linesSupport(vpts.back(), support[j]).size() < min_support) return false; 
+	}
+
+	float trackedFocal, err; 
+	selectOrthogonalVanishingPtsHelper(vpts, trackedFocal, err); 
+	if (err >= 0.05) return false; 
+
+	mVanishingPts = vpts; 
+	mOrthogonalVanishingPts = vpts; 
+	mFocal = trackedFocal; 
+	return true; 
 }
 
 bool
@@ -89,20 +153,29 @@ cv::Mat
 RansacVanishingPoint::getSketch() const
 {
 	cv::Mat m; 
-	mSketch.copyTo(m); 
-	if (orthogonalityDetected())
+	cv::cvtColor(mImage, m, CV_GRAY2BGR); 
+	Overlay overlay; 
+	getOverlay(overlay); 
+	overlay.draw(m); 
+	return m; 
+}
+
+void
+RansacVanishingPoint::getOverlay(Overlay & overlay) const
+{
+	// one segment from the image centre towards each vanishing point, clipped
+	// to the image diagonal
+	if (!orthogonalityDetected()) return; 
+	cv::Point2f c(mImage.cols/2, mImage.rows/2); 
+	float diagonal = hypot(mImage.rows, mImage.cols); 
+	for (size_t i = 0; i < mOrthogonalVanishingPts.size(); i++)
 	{
-		for (size_t i = 0; i < mOrthogonalVanishingPts.size(); i++)
-		{
-			cv::Point2f v; 
-			v = mOrthogonalVanishingPts[i];
-			if (hypot(v.x, v.y) > hypot(m.rows, m.cols))
-				v *= hypot(m.rows, m.cols) / hypot(v.x, v.y);
-			cv::line(m, cv::Point(m.cols/2, m.rows/2), 
-					cv::Point(v.x + m.cols/2, v.y + m.rows/2), cv::Scalar(255, 255, 0), 3, 8);
-		}
+		cv::Point2f v; 
+		v = mOrthogonalVanishingPts[i];
+		if (hypot(v.x, v.y) > diagonal)
+			v *= diagonal / hypot(v.x, v.y);
+		overlay.addSegment(c, c + v, cv::Scalar(255, 255, 0), 3.0f); 
 	}
-	return m * 1.0; 
 }
 
 cv::Mat 
@@ -223,25 +296,57 @@ RansacVanishingPoint::getVanishingPts() const
 	return mVanishingPts; 
 }
 
+const std::vector<cv::Vec4i> &
+RansacVanishingPoint::getLines() const
+{
+	// centred on the image, undistorted if a table was given
+	return mLines; 
+}
+
+size_t
+RansacVanishingPoint::getNumberOfLines() const
+{
+	return mLines.size(); 
+}
+
+size_t
+RansacVanishingPoint::getSupport() const
+{
+	size_t support = 0; 
+	for (size_t i = 0; i < mOrthogonalVanishingPts.size(); i++)
+		support += linesSupport(mOrthogonalVanishingPts[i], mLines).size(); 
+	return support; 
+}
+
+const LinePairStats &
+RansacVanishingPoint::getLinePairStats() const
+{
+	return mPairStats; 
+}
+
 void 
 RansacVanishingPoint::showLines(const std::vector<cv::Vec4i> & lines) const
 {
-
+#if LOG_SHOW_IMAGES
 		cv::namedWindow("lines"); 
 		cv::Mat m; 
-		mSketch.copyTo(m); 
+		cv::cvtColor(mImage, m, CV_GRAY2BGR); 
 		for (size_t i = 0; i < lines.size(); i++)
 			cv::line(m, cv::Point(lines[i][0], lines[i][1]) + cv::Point(m.cols/2, m.rows/2),cv::Point(lines[i][2], lines[i][3]) + cv::Point(m.cols/2, m.rows/2), cv::Scalar(255, 255, 0), 3, 8);
 		cv::imshow("lines", m); 
 		cv::waitKey(); 
+#else
+	(void)lines; 
+#endif
 }
 
 void
 RansacVanishingPoint::showVanishing(const std::vector<cv::Point2f> & vanishingPts) const
 {
+#if LOG_SHOW_IMAGES
 		cv::namedWindow("v", CV_WINDOW_KEEPRATIO); 
 		cv::Mat m; 
-		mSketch.copyTo(m); 
+		cv::cvtColor(mImage, m, CV_GRAY2BGR); 
 		for (size_t i = 0; i < vanishingPts.size(); i++)
 		{
 			cv::Point2f v; 
@@ -251,6 +356,9 @@ RansacVanishingPoint::showVanishing(const std::vector<cv::Point2f> & vanishingPt
 		}
 		cv::imshow("v", m); 
 		cv::waitKey(); 
+#else
+	(void)vanishingPts; 
+#endif
 }
 void
 RansacVanishingPoint::detectLines()
@@ -277,7 +385,7 @@ RansacVanishingPoint::randPerm(size_t n) const
 
 	for(size_t i = 0; i < n; i++) 
 	{	
-		size_t j = rand() % (n - i) + i;
+		size_t j = (*mRng)(n - i) + i;
 
 		size_t t = perm[j];
 		perm[j] = perm[i];
@@ -310,15 +418,20 @@ RansacVanishingPoint::intersectLines(const std::vector<cv::Vec4i> & lines) const
 	return cv::Point2f(x.at<double>(0), x.at<double>(1)); 
 }
 
-cv::Point2f
-RansacVanishingPoint::sampleVanishingPt(const std::vector<cv::Vec4i> & lines) const
+bool
+RansacVanishingPoint::sampleVanishingPt(const std::vector<cv::Vec4i> & lines, const LinePairFilter & filter, cv::Point2f & vpt) const
 {
-	std::vector<size_t> perm = randPerm(lines.size()); 
+	// nearly parallel or collinear pairs give unstable intersections, they
+	// are redrawn instead of using up an iteration
+	size_t i, j; 
+	if (!filter.samplePair(*mRng, i, j)) return false; 
+
 	std::vector<cv::Vec4i> sampleLines; 
-	sampleLines.push_back(lines[perm[0]]); 
-	sampleLines.push_back(lines[perm[1]]); 
+	sampleLines.push_back(lines[i]); 
+	sampleLines.push_back(lines[j]); 
 
-	return intersectLines(sampleLines); 
+	vpt = intersectLines(sampleLines); 
+	return true; 
 }
 
 float 
@@ -371,9 +484,20 @@ RansacVanishingPoint::ransac2Lines(const std::vector<cv::Vec4i> & lines) const
 	size_t it = 0; 
 	size_t max_inliers = 2; 
 	cv::Point2f vanishingPt; 
+	if (lines.size() < 2) return vanishingPt; 
+
+	LinePairFilter filter; 
+	filter.setLines(lines); 
 	while (it < k && it < max_iter)
 	{
-		cv::Point2f guess = sampleVanishingPt(lines); 
+		cv::Point2f guess; 
+		// only when the pairs drawn were all rejected, as for lines that are
+		// nearly all parallel
+		if (!sampleVanishingPt(lines, filter, guess))
+		{
+			it++; 
+			continue; 
+		}
 		size_t inliers = linesSupport(guess, lines).size(); 
 		if (inliers > max_inliers)
 		{
@@ -386,6 +510,7 @@ RansacVanishingPoint::ransac2Lines(const std::vector<cv::Vec4i> & lines) const
 		}
 		it++; 
 	}
+	mPairStats += filter.getStats(); 
 
 	return vanishingPt; 
 
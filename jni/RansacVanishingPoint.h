@@ -1,9 +1,15 @@
+#ifndef RANSACVANISHINGPOINT_H
+#define RANSACVANISHINGPOINT_H
+
 #include <opencv2/core/core.hpp>
 
+#include "LinePairFilter.h"
+#include "Overlay.h"
+#include "UndistortionMap.h"
+
 class RansacVanishingPoint
 {
 	cv::Mat mImage; 
-	cv::Mat mSketch; 
 	std::vector<cv::Vec4i> mLines; 
 	std::vector<cv::Point2f> mVanishingPts; 
 	std::vector<cv::Point2f> mOrthogonalVanishingPts; 
@@ -13,17 +19,27 @@ class RansacVanishingPoint
 	bool mFixFocal; 
 	bool mFixPriciplePt; 
 
+	mutable LinePairStats mPairStats; 
+	cv::RNG * mRng; 
+
 public: 
-	RansacVanishingPoint(const cv::Mat & image, cv::Point2f pp = cv::Point2f(-1.0f, -1.0f), float focal = -1.0f); 
+	RansacVanishingPoint(const cv::Mat & image, cv::Point2f pp = cv::Point2f(-1.0f, -1.0f), float focal = -1.0f, 
+						 const UndistortionMap * undistortion = NULL, cv::RNG * rng = NULL); 
 	float getFocal() const; 
 	cv::Mat getSketch() const; 
+	void getOverlay(Overlay & overlay) const; 
 	void findVanishingPts(); 
 	void findOrthogonalVanishingPts();
+	bool trackOrthogonalVanishingPts(const cv::Mat & rotation, float focal); 
 	bool orthogonalityDetected() const; 	
 	std::vector<cv::Point2f> selectOrthogonalVanishingPts() const; 
 	cv::Mat getRotation() const; 
 	void showVanishing(const std::vector<cv::Point2f> & vanishingPts) const; 
 	std::vector<cv::Point2f> getVanishingPts() const; 
+	const std::vector<cv::Vec4i> & getLines() const; 
+	size_t getNumberOfLines() const; 
+	size_t getSupport() const; 
+	const LinePairStats & getLinePairStats() const; 
 
 protected:
 	// No orthogonality
@@ -32,7 +48,7 @@ protected:
 	void detectLines(); 
 	std::vector<size_t> randPerm(size_t n) const; 
 	cv::Point2f intersectLines(const std::vector<cv::Vec4i> & lines) const; 
-	cv::Point2f sampleVanishingPt(const std::vector<cv::Vec4i> & lines) const; 
+	bool sampleVanishingPt(const std::vector<cv::Vec4i> & lines, const LinePairFilter & filter, cv::Point2f & vpt) const; 
 	float distance(cv::Point2f point, cv::Vec4f line) const; 
 	std::vector<cv::Vec4i> linesSupport(cv::Point2f point, const std::vector<cv::Vec4i> & lines) const; 
 	void removeVanishingLines(cv::Point2f vanishingPt, std::vector<cv::Vec4i> & lines) const; 
@@ -41,3 +57,5 @@ protected:
 
 	void showLines(const std::vector<cv::Vec4i> & lines) const; 
 }; 
+
+#endif
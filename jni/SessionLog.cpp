@@ -0,0 +1,172 @@
+#include "SessionLog.h"
+
+#include <cstring>
+#include <ctime>
+
+namespace
+{
+
+const uint32_t SESSION_VERSION = 1; 
+
+size_t
+padded(size_t size)
+{
+	return (size + 7) & ~(size_t)7; 
+}
+
+}
+
+SessionFileHeader
+createSessionFileHeader(cv::Size imageSize, cv::Size boardSize, float squareSize)
+{
+	SessionFileHeader header; 
+	memset(&header, 0, sizeof(header)); 
+	memcpy(header.magic, "MCSL", 4); 
+	header.version = SESSION_VERSION; 
+	header.imageWidth = imageSize.width; 
+	header.imageHeight = imageSize.height; 
+	header.boardWidth = boardSize.width; 
+	header.boardHeight = boardSize.height; 
+	header.squareSize = squareSize; 
+	return header; 
+}
+
+int64_t
+sessionTimestamp()
+{
+	struct timespec ts; 
+	clock_gettime(CLOCK_MONOTONIC, &ts); 
+	return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec; 
+}
+
+SessionLogWriter::SessionLogWriter()
+	: mFile(NULL), 
+	  mSuspended(false)
+{
+	pthread_mutex_init(&mMutex, NULL); 
+}
+
+SessionLogWriter::~SessionLogWriter()
+{
+	close(); 
+	pthread_mutex_destroy(&mMutex); 
+}
+
+bool
+SessionLogWriter::open(const char * path, const SessionFileHeader & header)
+{
+	close(); 
+	if (!path) return false; 
+	FILE * file = fopen(path, "wb"); 
+	if (!file) return false; 
+	if (fwrite(&header, sizeof(header), 1, file) != 1 || fflush(file) != 0)
+	{
+		fclose(file); 
+		return false; 
+	}
+
+	pthread_mutex_lock(&mMutex); 
+	mFile = file; 
+	pthread_mutex_unlock(&mMutex); 
+	return true; 
+}
+
+void
+SessionLogWriter::close()
+{
+	pthread_mutex_lock(&mMutex); 
+	if (mFile) fclose(mFile); 
+	mFile = NULL; 
+	pthread_mutex_unlock(&mMutex); 
+}
+
+bool
+SessionLogWriter::isOpen() const
+{
+	return mFile != NULL; 
+}
+
+void
+SessionLogWriter::suspend(bool suspended)
+{
+	mSuspended = suspended; 
+}
+
+bool
+SessionLogWriter::isLogging() const
+{
+	return mFile != NULL && !mSuspended; 
+}
+
+bool
+SessionLogWriter::append(uint32_t type, int64_t timestamp, const void * data, size_t size)
+{
+	static const char zeros[8] = { 0 }; 
+
+	SessionRecordHeader header; 
+	header.type = type; 
+	header.size = size; 
+	header.timestamp = timestamp; 
+
+	if (mSuspended) return false; 
+	pthread_mutex_lock(&mMutex); 
+	bool written = mFile != NULL
+		&& fwrite(&header, sizeof(header), 1, mFile) == 1
+		&& (size == 0 || fwrite(data, size, 1, mFile) == 1)
+		&& (padded(size) == size || fwrite(zeros, padded(size) - size, 1, mFile) == 1)
+		&& fflush(mFile) == 0; 
+	pthread_mutex_unlock(&mMutex); 
+	return written; 
+}
+
+SessionLogReader::SessionLogReader()
+	: mOffset(0)
+{
+}
+
+bool
+SessionLogReader::open(const char * path)
+{
+	mOffset = 0; 
+	if (!mFile.open(path)) return false; 
+
+	const SessionFileHeader * header = reinterpret_cast<const SessionFileHeader *>(mFile.data()); 
+	if (mFile.size() < sizeof(SessionFileHeader) || memcmp(header->magic, "MCSL", 4) != 0 
+		|| header->version != SESSION_VERSION)
+	{
+		mFile.close(); 
+		return false; 
+	}
+	mOffset = sizeof(SessionFileHeader); 
+	return true; 
+}
+
+void
+SessionLogReader::close()
+{
+	mFile.close(); 
+	mOffset = 0; 
+}
+
+const SessionFileHeader &
+SessionLogReader::getHeader() const
+{
+	return *reinterpret_cast<const SessionFileHeader *>(mFile.data()); 
+}
+
+bool
+SessionLogReader::next(SessionRecord & record)
+{
+	if (!mFile.isOpen() || mOffset + sizeof(SessionRecordHeader) > mFile.size()) return false; 
+
+	const SessionRecordHeader * header = reinterpret_cast<const SessionRecordHeader *>(mFile.data() + mOffset); 
+	size_t end = mOffset + sizeof(SessionRecordHeader) + header->size; 
+	if (end > mFile.size()) return false; 
+
+	record.type = header->type; 
+	record.timestamp = header->timestamp; 
+	record.data = mFile.data() + mOffset + sizeof(SessionRecordHeader); 
+	record.size = header->size; 
+	mOffset += sizeof(SessionRecordHeader) + padded(header->size); 
+	return true; 
+}
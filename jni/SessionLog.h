@@ -0,0 +1,90 @@
+#ifndef SESSIONLOG_H
+#define SESSIONLOG_H
+
+#include <cstdio>
+#include <pthread.h>
+#include <stdint.h>
+#include <opencv2/core/core.hpp>
+
+#include "MappedFile.h"
+
+#define SESSION_CHESSBOARD 1			// corners, cv::Point2f each
+#define SESSION_VANISHING_POINT 2		// rotation, 9 doubles row by row, then the focal as a double
+#define SESSION_IMU_GRAVITY 3			// 3 doubles
+#define SESSION_IMU_QUATERNION 4		// 3 doubles, vector part of a unit quaternion
+#define SESSION_PARTIAL_CHESSBOARD 5	// a partial or other size board: the grid size and its first column and row as cv::Point2f, then the corners
+
+// Layout of a session file: the header, then the records back to back. Every
+// record starts at a multiple of 8 bytes from the start of the file, so that
+// the payloads can be read in place from a mapping.
+struct SessionFileHeader
+{
+	char magic[4];						// "MCSL"
+	uint32_t version; 
+	int32_t imageWidth, imageHeight; 
+	int32_t boardWidth, boardHeight; 
+	float squareSize; 
+	uint32_t reserved; 
+}; 
+
+struct SessionRecordHeader
+{
+	uint32_t type; 
+	uint32_t size;						// payload bytes, without the padding
+	int64_t timestamp;					// nanoseconds, the frame time on the sensor event clock, or sessionTimestamp() for untimed frames
+}; 
+
+struct SessionRecord
+{
+	uint32_t type; 
+	int64_t timestamp; 
+	const char * data; 
+	size_t size; 
+}; 
+
+// Append-only writer. Every record is flushed as it is written, so a session
+// cut short by the app being killed loses at most the record being written.
+class SessionLogWriter
+{
+	FILE * mFile; 
+	bool mSuspended;					// while a log is replayed into the object writing this one
+	pthread_mutex_t mMutex; 
+
+	SessionLogWriter(const SessionLogWriter &); 
+	SessionLogWriter & operator=(const SessionLogWriter &); 
+
+public: 
+	SessionLogWriter(); 
+	~SessionLogWriter(); 
+
+	bool open(const char * path, const SessionFileHeader & header); 
+	void close(); 
+	bool isOpen() const; 
+	void suspend(bool suspended); 
+	// open and not suspended, appended records are written
+	bool isLogging() const; 
+
+	bool append(uint32_t type, int64_t timestamp, const void * data, size_t size); 
+}; 
+
+// Reader over a mapped session file; the records point into the mapping and
+// are valid until the reader is closed. A truncated last record is ignored.
+class SessionLogReader
+{
+	MappedFile mFile; 
+	size_t mOffset; 
+
+public: 
+	SessionLogReader(); 
+
+	bool open(const char * path); 
+	void close(); 
+
+	const SessionFileHeader & getHeader() const; 
+	bool next(SessionRecord & record); 
+}; 
+
+SessionFileHeader createSessionFileHeader(cv::Size imageSize, cv::Size boardSize, float squareSize); 
+int64_t sessionTimestamp();			// CLOCK_MONOTONIC, as System.nanoTime()
+
+#endif
@@ -0,0 +1,187 @@
+#include "UndistortionMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <list>
+#include <pthread.h>
+#include <opencv2/imgproc/imgproc.hpp>
+
+namespace
+{
+
+// a handful of parameter sets at most, the oldest goes first
+enum { CACHE_SIZE = 4 }; 
+pthread_mutex_t cacheMutex = PTHREAD_MUTEX_INITIALIZER; 
+std::list<UndistortionMapPtr> cache; 
+
+// maps are shared between threads, the remap tables are built by the first user
+pthread_mutex_t remapMutex = PTHREAD_MUTEX_INITIALIZER; 
+
+}
+
+UndistortionMap::UndistortionMap(const vcharge::CataCameraParameters & parameters, int gridStep)
+	: mCamera(parameters),
+	  mImageSize(parameters.imageWidth(), parameters.imageHeight()),
+	  mGridStep(std::max(gridStep, 1))
+{
+	// a ray near the axis projects at gamma / (1 + xi) times its slope
+	mFocal = 0.5 * (parameters.gamma1() + parameters.gamma2()) / (1.0 + parameters.xi()); 
+	mCentre = cv::Point2d(mImageSize.width / 2, mImageSize.height / 2); 
+
+	// the camera image to the pinhole on a grid, for points; one node past
+	// the last pixel so that every pixel has four nodes around it
+	mGridSize = cv::Size((mImageSize.width - 1) / mGridStep + 2, (mImageSize.height - 1) / mGridStep + 2); 
+	std::vector<float> nodes(2 * mGridSize.area()); 
+	for (int j = 0; j < mGridSize.height; j++)
+	{
+		for (int i = 0; i < mGridSize.width; i++)
+		{
+			nodes[2 * (j * mGridSize.width + i)] = i * mGridStep; 
+			nodes[2 * (j * mGridSize.width + i) + 1] = j * mGridStep; 
+		}
+	}
+	std::vector<float> lifted(3 * mGridSize.area()); 
+	mCamera.liftProjective(&nodes[0], &lifted[0], mGridSize.area()); 
+
+	mGrid.resize(mGridSize.area()); 
+	for (size_t k = 0; k < mGrid.size(); k++)
+	{
+		const float * P = &lifted[3 * k]; 
+		// behind the camera, or NaN where the ray does not reach the sphere
+		if (!(P[2] > 1e-6f))
+			mGrid[k] = cv::Point2f(std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::quiet_NaN()); 
+		else
+			mGrid[k] = cv::Point2f(mFocal * P[0] / P[2] + mCentre.x, mFocal * P[1] / P[2] + mCentre.y); 
+	}
+}
+
+UndistortionMapPtr
+UndistortionMap::get(const vcharge::CataCameraParameters & parameters)
+{
+	pthread_mutex_lock(&cacheMutex); 
+	UndistortionMapPtr map; 
+	for (std::list<UndistortionMapPtr>::iterator it = cache.begin(); it != cache.end(); ++it)
+	{
+		if (sameParameters((*it)->getParameters(), parameters))
+		{
+			map = *it; 
+			break; 
+		}
+	}
+	if (!map)
+	{
+		map.reset(new UndistortionMap(parameters)); 
+		cache.push_back(map); 
+		if (cache.size() > CACHE_SIZE) cache.pop_front(); 
+	}
+	pthread_mutex_unlock(&cacheMutex); 
+	return map; 
+}
+
+const vcharge::CataCameraParameters &
+UndistortionMap::getParameters() const
+{
+	return mCamera.parameters(); 
+}
+
+cv::Size
+UndistortionMap::getImageSize() const
+{
+	return mImageSize; 
+}
+
+cv::Matx33d
+UndistortionMap::getCameraMatrix() const
+{
+	return cv::Matx33d(mFocal, 0, mCentre.x,
+					   0, mFocal, mCentre.y,
+					   0, 0, 1); 
+}
+
+void
+UndistortionMap::undistortImage(const cv::Mat & image, cv::Mat & output) const
+{
+	pthread_mutex_lock(&remapMutex); 
+	if (mMapXY.empty()) buildRemapTables(); 
+	pthread_mutex_unlock(&remapMutex); 
+	cv::remap(image, output, mMapXY, mMapInterpolation, cv::INTER_LINEAR); 
+}
+
+bool
+UndistortionMap::undistortPoint(cv::Point2f point, cv::Point2f & undistorted) const
+{
+	float gx = point.x / mGridStep, gy = point.y / mGridStep; 
+	if (!(gx >= 0 && gy >= 0 && gx < mGridSize.width - 1 && gy < mGridSize.height - 1)) return false; 
+
+	int i = (int)gx, j = (int)gy; 
+	float ax = gx - i, ay = gy - j; 
+	const cv::Point2f * node = &mGrid[j * mGridSize.width + i]; 
+	undistorted = (1 - ay) * ((1 - ax) * node[0] + ax * node[1])
+		+ ay * ((1 - ax) * node[mGridSize.width] + ax * node[mGridSize.width + 1]); 
+	// NaN from a node behind the camera fails this
+	return undistorted.x == undistorted.x && undistorted.y == undistorted.y; 
+}
+
+void
+UndistortionMap::undistortLines(std::vector<cv::Vec4i> & lines) const
+{
+	size_t n = 0; 
+	for (size_t i = 0; i < lines.size(); i++)
+	{
+		cv::Point2f p0, p1; 
+		if (!undistortPoint(cv::Point2f(lines[i][0], lines[i][1]), p0)
+			|| !undistortPoint(cv::Point2f(lines[i][2], lines[i][3]), p1))
+			continue; 
+		lines[n++] = cv::Vec4i(cvRound(p0.x), cvRound(p0.y), cvRound(p1.x), cvRound(p1.y)); 
+	}
+	lines.resize(n); 
+}
+
+bool
+UndistortionMap::liftPoint(cv::Point2d point, cv::Point2d & undistorted) const
+{
+	cv::Point3d P; 
+	mCamera.liftProjective(point, P); 
+	if (!(P.z > 1e-6)) return false; 
+	undistorted = cv::Point2d(mFocal * P.x / P.z + mCentre.x, mFocal * P.y / P.z + mCentre.y); 
+	return true; 
+}
+
+bool
+UndistortionMap::projectPoint(cv::Point2d undistorted, cv::Point2d & point) const
+{
+	cv::Point3d P((undistorted.x - mCentre.x) / mFocal, (undistorted.y - mCentre.y) / mFocal, 1.0); 
+	if (!(1.0 + mCamera.parameters().xi() * sqrt(P.x * P.x + P.y * P.y + 1.0) > 1e-6)) return false; 
+	mCamera.spaceToPlane(P, point); 
+	return true; 
+}
+
+void
+UndistortionMap::buildRemapTables() const
+{
+	// for every pinhole pixel, where it comes from in the camera image; a
+	// row of rays at a time through the batched projection. The rays all
+	// have z = 1, so they are in front of the mirror for any xi >= 0
+	cv::Mat map(mImageSize, CV_32FC2); 
+	std::vector<float> rays(3 * mImageSize.width); 
+	for (int y = 0; y < mImageSize.height; y++)
+	{
+		for (int x = 0; x < mImageSize.width; x++)
+		{
+			rays[3 * x] = (x - mCentre.x) / mFocal; 
+			rays[3 * x + 1] = (y - mCentre.y) / mFocal; 
+			rays[3 * x + 2] = 1.0f; 
+		}
+		mCamera.spaceToPlane(&rays[0], map.ptr<float>(y), mImageSize.width); 
+	}
+	cv::convertMaps(map, cv::Mat(), mMapXY, mMapInterpolation, CV_16SC2); 
+}
+
+bool
+UndistortionMap::sameParameters(const vcharge::CataCameraParameters & a, const vcharge::CataCameraParameters & b)
+{
+	return a.imageWidth() == b.imageWidth() && a.imageHeight() == b.imageHeight()
+		&& a.xi() == b.xi() && a.k1() == b.k1() && a.k2() == b.k2() && a.p1() == b.p1() && a.p2() == b.p2()
+		&& a.gamma1() == b.gamma1() && a.gamma2() == b.gamma2() && a.u0() == b.u0() && a.v0() == b.v0(); 
+}
@@ -0,0 +1,58 @@
+#ifndef UNDISTORTIONMAP_H
+#define UNDISTORTIONMAP_H
+
+#include <vector>
+#include <tr1/memory>
+#include <opencv2/core/core.hpp>
+
+#include "CataCamera.h"
+
+class UndistortionMap; 
+typedef std::tr1::shared_ptr<const UndistortionMap> UndistortionMapPtr; 
+
+// Maps the image of a unified projection camera, as described by
+// CataCameraParameters, to a pinhole camera with the same focal length at
+// the centre and its principal point in the middle of the image, which is
+// what the vanishing point detectors assume. A coarse grid, interpolated
+// bilinearly, maps single points such as line endpoints and is built once per
+// parameter set; the full resolution remap tables for whole images are only
+// built on the first undistortImage().
+class UndistortionMap
+{
+	vcharge::CataCamera mCamera; 
+	cv::Size mImageSize; 
+	double mFocal; 
+	cv::Point2d mCentre; 
+
+	mutable cv::Mat mMapXY;				// CV_16SC2 and CV_16UC1, for cv::remap
+	mutable cv::Mat mMapInterpolation; 
+
+	int mGridStep; 
+	cv::Size mGridSize; 
+	std::vector<cv::Point2f> mGrid;		// pinhole position of every node, NaN if behind the camera
+
+public:
+	UndistortionMap(const vcharge::CataCameraParameters & parameters, int gridStep = 8); 
+
+	// shared by every user of the same parameters
+	static UndistortionMapPtr get(const vcharge::CataCameraParameters & parameters); 
+
+	const vcharge::CataCameraParameters & getParameters() const; 
+	cv::Size getImageSize() const; 
+	cv::Matx33d getCameraMatrix() const;	// of the pinhole camera
+
+	void undistortImage(const cv::Mat & image, cv::Mat & output) const; 
+	bool undistortPoint(cv::Point2f point, cv::Point2f & undistorted) const; 
+	// in place, lines with an endpoint that cannot be mapped are removed
+	void undistortLines(std::vector<cv::Vec4i> & lines) const; 
+
+	// the exact mappings the tables are built from
+	bool liftPoint(cv::Point2d point, cv::Point2d & undistorted) const; 
+	bool projectPoint(cv::Point2d undistorted, cv::Point2d & point) const; 
+
+protected:
+	void buildRemapTables() const; 
+	static bool sameParameters(const vcharge::CataCameraParameters & a, const vcharge::CataCameraParameters & b); 
+}; 
+
+#endif
@@ -0,0 +1,393 @@
+#include "VanishingPointEngine.h"
+
+#include <pthread.h>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+
+struct VanishingPointJob
+{
+	VanishingPointEngine * engine; 
+	const cv::Mat * image; 
+	const cv::Mat * rotation; 
+	float focal; 
+}; 
+
+void *
+processVanishingPointJob(void * arg)
+{
+	VanishingPointJob * job = static_cast<VanishingPointJob *>(arg); 
+	job->engine->process(*job->image, *job->rotation, job->focal); 
+	return NULL; 
+}
+
+}
+
+VanishingPointEngine *
+VanishingPointEngine::create(int type)
+{
+	switch (type)
+	{
+	case VP_ENGINE_RANSAC:
+		return new RansacVanishingPointEngine; 
+	case VP_ENGINE_CAS1D:
+		return new Cas1DVanishingPointEngine; 
+	default:
+		return NULL; 
+	}
+}
+
+void
+VanishingPointEngine::processInParallel(VanishingPointEngine ** engines, size_t n, 
+										const cv::Mat & image, const cv::Mat & rotation, float focal)
+{
+	// one thread per additional engine, the first one runs on the caller
+	std::vector<VanishingPointJob> jobs(n); 
+	std::vector<pthread_t> threads(n); 
+	std::vector<bool> started(n, false); 
+	for (size_t i = 0; i < n; i++)
+	{
+		jobs[i].engine = engines[i]; 
+		jobs[i].image = &image; 
+		jobs[i].rotation = &rotation; 
+		jobs[i].focal = focal; 
+		if (i > 0)
+			started[i] = pthread_create(&threads[i], NULL, processVanishingPointJob, &jobs[i]) == 0; 
+	}
+
+	if (n > 0) processVanishingPointJob(&jobs[0]); 
+	for (size_t i = 1; i < n; i++)
+	{
+		if (started[i]) pthread_join(threads[i], NULL); 
+		else processVanishingPointJob(&jobs[i]); 
+	}
+}
+
+VanishingPointEngine *
+VanishingPointEngine::selectConsistent(VanishingPointEngine ** engines, size_t n, VanishingPointEngine * preferred)
+{
+	// the support of each engine counts its own lines, detected with its own
+	// thresholds, so the results are scored on the lines of all of them
+	// under one angular threshold; the preferred engine wins ties
+	std::vector<cv::Vec4i> lines; 
+	for (size_t i = 0; i < n; i++)
+		if (engines[i]->getStats().lines > 0)
+			lines.insert(lines.end(), engines[i]->getLines().begin(), engines[i]->getLines().end()); 
+
+	VanishingPointEngine * selected = preferred; 
+	for (size_t i = 0; i < n; i++)
+	{
+		VanishingPointStats & stats = engines[i]->mStats; 
+		if (!stats.success) continue; 
+		stats.consistent = engines[i]->countConsistentLines(lines, CV_PI / 90); 
+	}
+	for (size_t i = 0; i < n; i++)
+	{
+		const VanishingPointStats & stats = engines[i]->getStats(); 
+		if (!stats.success) continue; 
+		if (!selected->getStats().success || stats.consistent > selected->getStats().consistent)
+			selected = engines[i]; 
+	}
+	return selected; 
+}
+
+bool
+VanishingPointEngine::process(const cv::Mat & image, const cv::Mat & rotation, float focal)
+{
+	int64 start = cv::getTickCount(); 
+
+	mStats = VanishingPointStats(); 
+	if (!rotation.empty() && focal > 0)
+		mStats.success = track(image, rotation, focal); 
+	else 
+		mStats.success = detect(image); 
+	// a frame without a usable focal is of no use to the calibration
+	if (mStats.success && !(getFocal() > 0)) mStats.success = false; 
+
+	mStats.lines = getNumberOfLines(); 
+	mStats.support = mStats.success ? getSupport() : 0; 
+	mStats.pairs = getLinePairStats(); 
+	mStats.milliseconds = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency(); 
+	return mStats.success; 
+}
+
+bool
+VanishingPointEngine::track(const cv::Mat & image, const cv::Mat &, float)
+{
+	return detect(image); 
+}
+
+size_t
+VanishingPointEngine::countConsistentLines(const std::vector<cv::Vec4i> & lines, double maxAngle) const
+{
+	// a line is consistent with a vanishing point when the direction from
+	// its midpoint to the point is within maxAngle of the line; the points
+	// may be at infinity
+	std::vector<cv::Vec3d> points = getVanishingPoints(); 
+	double maxSin = sin(maxAngle); 
+	size_t count = 0; 
+	for (size_t i = 0; i < lines.size(); i++)
+	{
+		double lx = lines[i][2] - lines[i][0]; 
+		double ly = lines[i][3] - lines[i][1]; 
+		double mx = 0.5 * (lines[i][0] + lines[i][2]); 
+		double my = 0.5 * (lines[i][1] + lines[i][3]); 
+		double length = hypot(lx, ly); 
+		for (size_t k = 0; k < points.size(); k++)
+		{
+			double tx = points[k][0] - points[k][2] * mx; 
+			double ty = points[k][1] - points[k][2] * my; 
+			double t = hypot(tx, ty); 
+			if (length == 0 || t == 0) continue; 
+			if (fabs(lx * ty - ly * tx) < maxSin * length * t)
+			{
+				count++; 
+				break; 
+			}
+		}
+	}
+	return count; 
+}
+
+const VanishingPointStats &
+VanishingPointEngine::getStats() const
+{
+	return mStats; 
+}
+
+void
+VanishingPointEngine::setUndistortion(const UndistortionMapPtr & undistortion)
+{
+	mUndistortion = undistortion; 
+}
+
+const UndistortionMap *
+VanishingPointEngine::getUndistortion(const cv::Mat & image) const
+{
+	// the tables are only valid at the resolution they were built for
+	if (!mUndistortion || mUndistortion->getImageSize() != image.size()) return NULL; 
+	return mUndistortion.get(); 
+}
+
+bool
+RansacVanishingPointEngine::detect(const cv::Mat & image)
+{
+	mDetector.reset(new RansacVanishingPoint(image, cv::Point2f(-1.0f, -1.0f), -1.0f, getUndistortion(image), &mRng)); 
+	mDetector->findOrthogonalVanishingPts(); 
+	return mDetector->orthogonalityDetected(); 
+}
+
+bool
+RansacVanishingPointEngine::track(const cv::Mat & image, const cv::Mat & rotation, float focal)
+{
+	mDetector.reset(new RansacVanishingPoint(image, cv::Point2f(-1.0f, -1.0f), -1.0f, getUndistortion(image), &mRng)); 
+	mStats.tracked = mDetector->trackOrthogonalVanishingPts(rotation, focal); 
+	if (!mStats.tracked) mDetector->findOrthogonalVanishingPts(); 
+	return mDetector->orthogonalityDetected(); 
+}
+
+cv::Mat
+RansacVanishingPointEngine::getRotation() const
+{
+	return mDetector->getRotation(); 
+}
+
+float
+RansacVanishingPointEngine::getFocal() const
+{
+	return mDetector->getFocal(); 
+}
+
+cv::Mat
+RansacVanishingPointEngine::getSketch() const
+{
+	return mDetector->getSketch(); 
+}
+
+void
+RansacVanishingPointEngine::getOverlay(Overlay & overlay) const
+{
+	mDetector->getOverlay(overlay); 
+}
+
+int
+RansacVanishingPointEngine::getType() const
+{
+	return VP_ENGINE_RANSAC; 
+}
+
+std::vector<cv::Vec3d>
+RansacVanishingPointEngine::getVanishingPoints() const
+{
+	// the columns of the rotation are (x, y, f) normalized, up to sign
+	cv::Mat R = getRotation(); 
+	double focal = getFocal(); 
+	std::vector<cv::Vec3d> points; 
+	for (int i = 0; !R.empty() && i < 3; i++)
+		points.push_back(cv::Vec3d(R.at<double>(0, i), R.at<double>(1, i), R.at<double>(2, i) / focal)); 
+	return points; 
+}
+
+const std::vector<cv::Vec4i> &
+RansacVanishingPointEngine::getLines() const
+{
+	return mDetector->getLines(); 
+}
+
+size_t
+RansacVanishingPointEngine::getNumberOfLines() const
+{
+	return mDetector->getNumberOfLines(); 
+}
+
+size_t
+RansacVanishingPointEngine::getSupport() const
+{
+	return mDetector->getSupport(); 
+}
+
+LinePairStats
+RansacVanishingPointEngine::getLinePairStats() const
+{
+	return mDetector->getLinePairStats(); 
+}
+
+bool
+Cas1DVanishingPointEngine::detect(const cv::Mat & image)
+{
+	mDetector.reset(new Cas1DVanishingPoint(image, getUndistortion(image), &mRng)); 
+	mDetector->findOrthogonalVanishingPts(); 
+	return mDetector->focalAvailable(); 
+}
+
+cv::Mat
+Cas1DVanishingPointEngine::getRotation() const
+{
+	return mDetector->getRotation(); 
+}
+
+float
+Cas1DVanishingPointEngine::getFocal() const
+{
+	return mDetector->getFocal(); 
+}
+
+cv::Mat
+Cas1DVanishingPointEngine::getSketch() const
+{
+	return mDetector->getSketch(); 
+}
+
+void
+Cas1DVanishingPointEngine::getOverlay(Overlay & overlay) const
+{
+	mDetector->getOverlay(overlay); 
+}
+
+int
+Cas1DVanishingPointEngine::getType() const
+{
+	return VP_ENGINE_CAS1D; 
+}
+
+std::vector<cv::Vec3d>
+Cas1DVanishingPointEngine::getVanishingPoints() const
+{
+	// the columns of the rotation are (x, y, -f) normalized
+	cv::Mat R = getRotation(); 
+	double focal = getFocal(); 
+	std::vector<cv::Vec3d> points; 
+	for (int i = 0; !R.empty() && i < 3; i++)
+		points.push_back(cv::Vec3d(R.at<double>(0, i), R.at<double>(1, i), -R.at<double>(2, i) / focal)); 
+	return points; 
+}
+
+const std::vector<cv::Vec4i> &
+Cas1DVanishingPointEngine::getLines() const
+{
+	return mDetector->getLines(); 
+}
+
+size_t
+Cas1DVanishingPointEngine::getNumberOfLines() const
+{
+	return mDetector->getNumberOfLines(); 
+}
+
+size_t
+Cas1DVanishingPointEngine::getSupport() const
+{
+	return mDetector->getSupport(); 
+}
+
+LinePairStats
+Cas1DVanishingPointEngine::getLinePairStats() const
+{
+	return mDetector->getLinePairStats(); 
+}
+
+VanishingPointEngineSet::VanishingPointEngineSet()
+	: mSelected(VP_ENGINE_RANSAC), 
+	  mParallel(false), 
+	  mLast(-1)
+{
+	for (int i = 0; i < VP_ENGINE_COUNT; i++)
+		mEngines[i].reset(VanishingPointEngine::create(i)); 
+}
+
+void
+VanishingPointEngineSet::select(int type)
+{
+	assert(type >= 0 && type < VP_ENGINE_COUNT); 
+	mSelected = type; 
+}
+
+void
+VanishingPointEngineSet::setParallel(bool enable)
+{
+	mParallel = enable; 
+}
+
+void
+VanishingPointEngineSet::setUndistortion(const UndistortionMapPtr & undistortion)
+{
+	for (int i = 0; i < VP_ENGINE_COUNT; i++)
+		mEngines[i]->setUndistortion(undistortion); 
+}
+
+VanishingPointEngine *
+VanishingPointEngineSet::process(const cv::Mat & image, const cv::Mat & rotation, float focal)
+{
+	VanishingPointEngine * selected = mEngines[mSelected].get(); 
+	if (!mParallel)
+	{
+		selected->process(image, rotation, focal); 
+		mLast = mSelected; 
+		return selected; 
+	}
+
+	// run every engine on the same image and keep the result most
+	// consistent with the lines of all of them; the selected engine wins
+	// ties
+	VanishingPointEngine * engines[VP_ENGINE_COUNT]; 
+	for (int i = 0; i < VP_ENGINE_COUNT; i++)
+		engines[i] = mEngines[i].get(); 
+	VanishingPointEngine::processInParallel(engines, VP_ENGINE_COUNT, image, rotation, focal); 
+	selected = VanishingPointEngine::selectConsistent(engines, VP_ENGINE_COUNT, selected); 
+	mLast = selected->getType(); 
+	return selected; 
+}
+
+const VanishingPointEngine &
+VanishingPointEngineSet::getEngine(int type) const
+{
+	return *mEngines[type]; 
+}
+
+int
+VanishingPointEngineSet::getLastType() const
+{
+	return mLast; 
+}
@@ -0,0 +1,135 @@
+#ifndef VANISHINGPOINTENGINE_H
+#define VANISHINGPOINTENGINE_H
+
+#include <opencv2/core/core.hpp>
+#include <tr1/memory>
+
+#include "Cas1DVanishingPoint.h"
+#include "RansacVanishingPoint.h"
+
+#define VP_ENGINE_RANSAC 0
+#define VP_ENGINE_CAS1D 1
+#define VP_ENGINE_COUNT 2
+
+struct VanishingPointStats
+{
+	VanishingPointStats() : success(false), tracked(false), lines(0), support(0), consistent(0), milliseconds(0.0) {}
+
+	bool success;						// Manhattan frame and focal found
+	bool tracked;						// found from the previous frame
+	size_t lines;						// detected line segments
+	size_t support;						// lines supporting the three points
+	size_t consistent;					// lines of every engine in processInParallel that
+										// point at one of the three, see countConsistentLines
+	double milliseconds;				// wall time of the last process()
+	LinePairStats pairs;				// line pairs tested and rejected
+};
+
+// Common interface of the vanishing point detectors, so that MutualCalibration
+// can select one at runtime or run several on the same image.
+class VanishingPointEngine
+{
+protected:
+	VanishingPointStats mStats; 
+	UndistortionMapPtr mUndistortion; 
+	cv::RNG mRng;						// per engine, engines may run concurrently
+
+public: 
+	virtual ~VanishingPointEngine() {}
+
+	static VanishingPointEngine * create(int type); 
+	static void processInParallel(VanishingPointEngine ** engines, size_t n, 
+								  const cv::Mat & image, const cv::Mat & rotation = cv::Mat(), float focal = -1.0f); 
+	static VanishingPointEngine * selectConsistent(VanishingPointEngine ** engines, size_t n, VanishingPointEngine * preferred); 
+
+	bool process(const cv::Mat & image, const cv::Mat & rotation = cv::Mat(), float focal = -1.0f); 
+
+	virtual bool detect(const cv::Mat & image) = 0; 
+	virtual bool track(const cv::Mat & image, const cv::Mat & rotation, float focal); 
+	virtual cv::Mat getRotation() const = 0; 
+	virtual float getFocal() const = 0; 
+	virtual cv::Mat getSketch() const = 0; 
+	virtual void getOverlay(Overlay & overlay) const = 0; 
+	virtual int getType() const = 0; 
+	const VanishingPointStats & getStats() const; 
+	void setUndistortion(const UndistortionMapPtr & undistortion); 
+	size_t countConsistentLines(const std::vector<cv::Vec4i> & lines, double maxAngle) const; 
+
+protected:
+	const UndistortionMap * getUndistortion(const cv::Mat & image) const; 
+	// homogeneous, in the centred image coordinates of the lines
+	virtual std::vector<cv::Vec3d> getVanishingPoints() const = 0; 
+	virtual const std::vector<cv::Vec4i> & getLines() const = 0; 
+	virtual size_t getNumberOfLines() const = 0; 
+	virtual size_t getSupport() const = 0; 
+	virtual LinePairStats getLinePairStats() const = 0; 
+}; 
+
+typedef std::tr1::shared_ptr<VanishingPointEngine> VanishingPointEnginePtr; 
+
+class RansacVanishingPointEngine : public VanishingPointEngine
+{
+	std::tr1::shared_ptr<RansacVanishingPoint> mDetector; 
+
+public: 
+	bool detect(const cv::Mat & image); 
+	bool track(const cv::Mat & image, const cv::Mat & rotation, float focal); 
+	cv::Mat getRotation() const; 
+	float getFocal() const; 
+	cv::Mat getSketch() const; 
+	void getOverlay(Overlay & overlay) const; 
+	int getType() const; 
+
+protected:
+	std::vector<cv::Vec3d> getVanishingPoints() const; 
+	const std::vector<cv::Vec4i> & getLines() const; 
+	size_t getNumberOfLines() const; 
+	size_t getSupport() const; 
+	LinePairStats getLinePairStats() const; 
+}; 
+
+class Cas1DVanishingPointEngine : public VanishingPointEngine
+{
+	std::tr1::shared_ptr<Cas1DVanishingPoint> mDetector; 
+
+public: 
+	bool detect(const cv::Mat & image); 
+	cv::Mat getRotation() const; 
+	float getFocal() const; 
+	cv::Mat getSketch() const; 
+	void getOverlay(Overlay & overlay) const; 
+	int getType() const; 
+
+protected:
+	std::vector<cv::Vec3d> getVanishingPoints() const; 
+	const std::vector<cv::Vec4i> & getLines() const; 
+	size_t getNumberOfLines() const; 
+	size_t getSupport() const; 
+	LinePairStats getLinePairStats() const; 
+}; 
+
+// One engine of each type, run one at a time or all on the same image, see
+// MutualCalibration::setParallelVanishingPointEngines.
+class VanishingPointEngineSet
+{
+	VanishingPointEnginePtr mEngines[VP_ENGINE_COUNT]; 
+	int mSelected; 
+	bool mParallel; 
+	int mLast;							// engine whose result was used for the last image
+
+public: 
+	VanishingPointEngineSet(); 
+
+	void select(int type); 
+	void setParallel(bool enable); 
+	void setUndistortion(const UndistortionMapPtr & undistortion); 
+
+	// the selected engine, or with every engine run the one whose result is
+	// most consistent; it provides the sketch on failure
+	VanishingPointEngine * process(const cv::Mat & image, const cv::Mat & rotation, float focal); 
+
+	const VanishingPointEngine & getEngine(int type) const; 
+	int getLastType() const; 
+}; 
+
+#endif
@@ -0,0 +1,57 @@
+#include "VanishingPointTracker.h"
+
+VanishingPointTracker::VanishingPointTracker()
+	: mEnabled(false), 
+	  mFocal(-1.0f)
+{
+}
+
+void
+VanishingPointTracker::setEnabled(bool enable)
+{
+	mEnabled = enable; 
+	if (!enable) lose(); 
+}
+
+void
+VanishingPointTracker::setIMURotationDelta(const cv::Mat & delta)
+{
+	// rotation of the device since the previous vanishing point image
+	delta.copyTo(mIMURotationDelta); 
+}
+
+cv::Mat
+VanishingPointTracker::predict(const cv::Matx33d & alignment)
+{
+	cv::Mat prediction; 
+	if (mEnabled && !mRotation.empty())
+	{
+		prediction = mRotation; 
+		if (!mIMURotationDelta.empty())
+		{
+			cv::Mat ideal(alignment); 
+			prediction = ideal.t() * mIMURotationDelta * ideal * mRotation; 
+		}
+	}
+	mIMURotationDelta.release(); 
+	return prediction; 
+}
+
+float
+VanishingPointTracker::getFocal() const
+{
+	return mFocal; 
+}
+
+void
+VanishingPointTracker::update(const cv::Mat & rotation, float focal)
+{
+	rotation.copyTo(mRotation); 
+	mFocal = focal; 
+}
+
+void
+VanishingPointTracker::lose()
+{
+	mRotation.release(); 
+}
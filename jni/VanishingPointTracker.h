@@ -0,0 +1,32 @@
+#ifndef VANISHINGPOINTTRACKER_H
+#define VANISHINGPOINTTRACKER_H
+
+#include <opencv2/core/core.hpp>
+
+// The Manhattan frame of the last vanishing point image, to start the search
+// in the next one from. The device rotation between the two images, when the
+// caller knows it, moves the prediction along; the prediction is dropped
+// when an image loses the frame.
+class VanishingPointTracker
+{
+	bool mEnabled; 
+	cv::Mat mRotation;					// empty until an image is found, and once lost
+	float mFocal;						// of the last image found, -1 before the first
+	cv::Mat mIMURotationDelta;			// device rotation since that image, if known
+
+public: 
+	VanishingPointTracker(); 
+
+	void setEnabled(bool enable); 
+	void setIMURotationDelta(const cv::Mat & delta); 
+
+	// the rotation to track in the next image, empty for a full search;
+	// alignment is the camera to imu axis permutation. Uses up the delta
+	cv::Mat predict(const cv::Matx33d & alignment); 
+	float getFocal() const; 
+
+	void update(const cv::Mat & rotation, float focal); 
+	void lose(); 
+}; 
+
+#endif
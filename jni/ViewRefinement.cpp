@@ -0,0 +1,157 @@
+#include "ViewRefinement.h"
+
+#include <algorithm>
+#include <cmath>
+#include <pthread.h>
+#include <unistd.h>
+#include <opencv2/calib3d/calib3d.hpp>
+
+namespace
+{
+
+// shared by the workers, each one takes the next view from next
+struct ViewJob
+{
+	const std::vector<cv::Mat> * objectPoints; 
+	const std::vector<std::vector<cv::Point2f> > * imagePoints; 
+	const cv::Mat * cameraMatrix; 
+	const cv::Mat * distCoeffs; 
+	bool useGuess; 
+	std::vector<ViewResult> * results; 
+	volatile size_t next; 
+}; 
+
+void
+processView(const ViewJob & job, size_t i)
+{
+	ViewResult & result = (*job.results)[i]; 
+	const std::vector<cv::Point2f> & corners = (*job.imagePoints)[i]; 
+	const cv::Mat & boardPoints = (*job.objectPoints)[i]; 
+	cv::solvePnP(boardPoints, corners, *job.cameraMatrix, *job.distCoeffs,
+				 result.rvec, result.tvec, job.useGuess); 
+
+	cv::Mat R; 
+	cv::Rodrigues(result.rvec, R); 
+	result.R = cv::Matx33d(R); 
+
+	std::vector<cv::Point2f> projected; 
+	cv::projectPoints(boardPoints, result.rvec, result.tvec, *job.cameraMatrix, *job.distCoeffs, projected); 
+	double sum = 0; 
+	for (size_t k = 0; k < corners.size(); k++)
+	{
+		cv::Point2f d = projected[k] - corners[k]; 
+		sum += d.x * d.x + d.y * d.y; 
+	}
+	result.rms = corners.empty() ? 0 : sqrt(sum / corners.size()); 
+}
+
+void *
+processViewJob(void * arg)
+{
+	ViewJob * job = static_cast<ViewJob *>(arg); 
+	size_t n = job->results->size(); 
+	for (size_t i = __sync_fetch_and_add(&job->next, 1); i < n; i = __sync_fetch_and_add(&job->next, 1))
+		processView(*job, i); 
+	return NULL; 
+}
+
+}
+
+ViewRefinement::ViewRefinement(int threads, double threshold)
+	: mThreads(threads),
+	  mThreshold(threshold)
+{
+}
+
+void
+ViewRefinement::setThreads(int threads)
+{
+	mThreads = threads; 
+}
+
+void
+ViewRefinement::setThreshold(double pixels)
+{
+	mThreshold = pixels; 
+}
+
+double
+ViewRefinement::getThreshold() const
+{
+	return mThreshold; 
+}
+
+const ViewRefinementStats &
+ViewRefinement::getStats() const
+{
+	return mStats; 
+}
+
+bool
+ViewRefinement::canExcludeOutliers() const
+{
+	return mStats.outliers > 0 && mStats.views - mStats.outliers >= MIN_VIEWS; 
+}
+
+void
+ViewRefinement::process(const std::vector<cv::Mat> & objectPoints,
+						const std::vector<std::vector<cv::Point2f> > & imagePoints,
+						const cv::Mat & cameraMatrix, const cv::Mat & distCoeffs,
+						const std::vector<cv::Mat> & rvecs, const std::vector<cv::Mat> & tvecs,
+						std::vector<ViewResult> & results)
+{
+	int64 start = cv::getTickCount(); 
+	size_t n = imagePoints.size(); 
+
+	ViewJob job; 
+	job.objectPoints = &objectPoints; 
+	job.imagePoints = &imagePoints; 
+	job.cameraMatrix = &cameraMatrix; 
+	job.distCoeffs = &distCoeffs; 
+	job.useGuess = rvecs.size() == n && tvecs.size() == n; 
+	job.results = &results; 
+	job.next = 0; 
+
+	results.assign(n, ViewResult()); 
+	if (job.useGuess)
+	{
+		// solvePnP refines in place
+		for (size_t i = 0; i < n; i++)
+		{
+			rvecs[i].convertTo(results[i].rvec, CV_64F); 
+			tvecs[i].convertTo(results[i].tvec, CV_64F); 
+		}
+	}
+
+	// a thread costs more than a few views, the caller counts as one of them
+	enum { MIN_VIEWS_PER_THREAD = 4 }; 
+	int threads = mThreads > 0 ? mThreads : (int)sysconf(_SC_NPROCESSORS_ONLN); 
+	threads = std::max(1, std::min(threads, (int)(n / MIN_VIEWS_PER_THREAD))); 
+
+	std::vector<pthread_t> workers(threads); 
+	std::vector<bool> started(threads, false); 
+	for (int i = 1; i < threads; i++)
+		started[i] = pthread_create(&workers[i], NULL, processViewJob, &job) == 0; 
+	processViewJob(&job); 
+	for (int i = 1; i < threads; i++)
+		if (started[i]) pthread_join(workers[i], NULL); 
+
+	mStats = ViewRefinementStats(); 
+	mStats.views = n; 
+	mStats.threads = threads; 
+	double sum = 0; 
+	size_t corners = 0; 
+	for (size_t i = 0; i < n; i++)
+	{
+		results[i].outlier = results[i].rms > mThreshold; 
+		if (results[i].outlier)
+		{
+			mStats.outliers++; 
+			continue; 
+		}
+		sum += results[i].rms * results[i].rms * imagePoints[i].size(); 
+		corners += imagePoints[i].size(); 
+	}
+	mStats.rms = corners > 0 ? sqrt(sum / corners) : 0; 
+	mStats.milliseconds = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency(); 
+}
@@ -0,0 +1,61 @@
+#ifndef VIEWREFINEMENT_H
+#define VIEWREFINEMENT_H
+
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+struct ViewResult
+{
+	cv::Mat rvec, tvec; 
+	cv::Matx33d R; 
+	double rms;							// reprojection error, in pixels
+	bool outlier; 
+}; 
+
+struct ViewRefinementStats
+{
+	ViewRefinementStats() : views(0), outliers(0), threads(0), rms(0), milliseconds(0) {}
+
+	size_t views; 
+	size_t outliers; 
+	int threads; 
+	double rms;							// over the views that are kept
+	double milliseconds; 
+}; 
+
+// Board pose and reprojection error of every chessboard view once the
+// intrinsics are known. The views do not depend on each other, so a few
+// worker threads each take the next view left until there are none; a view
+// whose error is above the threshold is flagged as an outlier.
+class ViewRefinement
+{
+	static const size_t MIN_VIEWS = 3; 
+
+	int mThreads; 
+	double mThreshold; 
+	ViewRefinementStats mStats; 
+
+public:
+	// threads 0 uses one per core
+	ViewRefinement(int threads = 0, double threshold = 2.0); 
+
+	void setThreads(int threads); 
+	void setThreshold(double pixels); 
+	double getThreshold() const; 
+
+	// objectPoints holds the board of each view as cv::calibrateCamera takes
+	// them; rvecs and tvecs, as from cv::calibrateCamera, are refined if
+	// given, otherwise the poses are solved from scratch
+	void process(const std::vector<cv::Mat> & objectPoints,
+				 const std::vector<std::vector<cv::Point2f> > & imagePoints,
+				 const cv::Mat & cameraMatrix, const cv::Mat & distCoeffs,
+				 const std::vector<cv::Mat> & rvecs, const std::vector<cv::Mat> & tvecs,
+				 std::vector<ViewResult> & results); 
+
+	const ViewRefinementStats & getStats() const; 
+	// whether the outliers of the last process() can be left out, which
+	// needs at least MIN_VIEWS views left
+	bool canExcludeOutliers() const; 
+}; 
+
+#endif
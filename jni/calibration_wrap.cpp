@@ -985,6 +985,83 @@ SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_Mutu
 }
 
 
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1tryAddingNV21Image(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jbyteArray jarg2, jint jarg4, jlong jarg5) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  char *arg2 = (char *) 0 ;
+  size_t arg3 ;
+  int arg4 ;
+  cv::Mat *arg5 = 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  {
+    arg2 = (char *) jenv->GetByteArrayElements(jarg2, 0); 
+    if (!arg2) return 0; 
+    arg3 = (size_t) jenv->GetArrayLength(jarg2); 
+  }
+  arg4 = (int)jarg4; 
+  arg5 = *(cv::Mat **)&jarg5;
+  if (!arg5) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException, "cv::Mat & reference is null");
+    return 0;
+  } 
+  result = (bool)(arg1)->tryAddingNV21Image(arg2,arg3,arg4,*arg5);
+  jresult = (jboolean)result; 
+  {
+    jenv->ReleaseByteArrayElements(jarg2, (jbyte *) arg2, JNI_ABORT); 
+  }
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setOverlayDrawing(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jboolean jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  bool arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = jarg2 ? true : false; 
+  (arg1)->setOverlayDrawing(arg2);
+}
+
+
+SWIGEXPORT jlong JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getOverlaySize(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jlong jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  size_t result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  result = (size_t)((MutualCalibration const *)arg1)->getOverlaySize();
+  jresult = (jlong)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getOverlay(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jfloatArray jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  float *arg2 ;
+  jfloat *jarr2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  if (!SWIG_JavaArrayInFloat(jenv, &jarr2, &arg2, jarg2)) return ; 
+  ((MutualCalibration const *)arg1)->getOverlay(arg2);
+  SWIG_JavaArrayArgoutFloat(jenv, jarr2, arg2, jarg2); 
+  delete [] arg2; 
+}
+
+
 SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1addFullIMURotationByQuaternion(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdouble jarg2, jdouble jarg3, jdouble jarg4) {
   MutualCalibration *arg1 = (MutualCalibration *) 0 ;
   double arg2 ;
@@ -1019,22 +1096,117 @@ SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCa
 }
 
 
-SWIGEXPORT jlong JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getNumberOfImages(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
-  jlong jresult = 0 ;
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1addIMUSample(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jlong jarg2, jdouble jarg3, jdouble jarg4, jdouble jarg5) {
   MutualCalibration *arg1 = (MutualCalibration *) 0 ;
-  size_t result;
+  long long arg2 ;
+  double arg3 ;
+  double arg4 ;
+  double arg5 ;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
   arg1 = *(MutualCalibration **)&jarg1; 
-  result = ((MutualCalibration const *)arg1)->getNumberOfImages();
-  jresult = (jlong)result; 
+  arg2 = (long long)jarg2; 
+  arg3 = (double)jarg3; 
+  arg4 = (double)jarg4; 
+  arg5 = (double)jarg5; 
+  (arg1)->addIMUSample(arg2,arg3,arg4,arg5);
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setIMUTimeConstant(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdouble jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  double arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = (double)jarg2; 
+  (arg1)->setIMUTimeConstant(arg2);
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getIMUAtTimestamp(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jlong jarg2, jdoubleArray jarg3) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  long long arg2 ;
+  double *arg3 ;
+  jdouble *jarr3 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = (long long)jarg2; 
+  if (!SWIG_JavaArrayInDouble(jenv, &jarr3, &arg3, jarg3)) return 0; 
+  result = (bool)((MutualCalibration const *)arg1)->getIMUAtTimestamp(arg2,arg3);
+  jresult = (jboolean)result; 
+  SWIG_JavaArrayArgoutDouble(jenv, jarr3, arg3, jarg3); 
+  delete [] arg3; 
   return jresult;
 }
 
 
-SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getRotationMatrix(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdoubleArray jarg2) {
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setVanishingPointTracking(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jboolean jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  bool arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = jarg2 ? true : false; 
+  (arg1)->setVanishingPointTracking(arg2);
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setIMURotationDelta(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdouble jarg2, jdouble jarg3, jdouble jarg4) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  double arg2 ;
+  double arg3 ;
+  double arg4 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = (double)jarg2; 
+  arg3 = (double)jarg3; 
+  arg4 = (double)jarg4; 
+  (arg1)->setIMURotationDelta(arg2,arg3,arg4);
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setVanishingPointEngine(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  int arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = (int)jarg2; 
+  (arg1)->setVanishingPointEngine(arg2);
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setParallelVanishingPointEngines(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jboolean jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  bool arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = jarg2 ? true : false; 
+  (arg1)->setParallelVanishingPointEngines(arg2);
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getVanishingPointStats(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdoubleArray jarg2) {
   MutualCalibration *arg1 = (MutualCalibration *) 0 ;
   double *arg2 ;
   jdouble *jarr2 ;
@@ -1044,23 +1216,829 @@ SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCa
   (void)jarg1_;
   arg1 = *(MutualCalibration **)&jarg1; 
   if (!SWIG_JavaArrayInDouble(jenv, &jarr2, &arg2, jarg2)) return ; 
-  ((MutualCalibration const *)arg1)->getRotationMatrix(arg2);
+  ((MutualCalibration const *)arg1)->getVanishingPointStats(arg2);
   SWIG_JavaArrayArgoutDouble(jenv, jarr2, arg2, jarg2); 
   delete [] arg2; 
 }
 
 
-SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getCameraMatrix(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdoubleArray jarg2) {
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setCameraParameters(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2, jint jarg3, jdouble jarg4, jdouble jarg5, jdouble jarg6, jdouble jarg7, jdouble jarg8, jdouble jarg9, jdouble jarg10, jdouble jarg11, jdouble jarg12) {
+  jboolean jresult = 0 ;
   MutualCalibration *arg1 = (MutualCalibration *) 0 ;
-  double *arg2 ;
-  jdouble *jarr2 ;
+  int arg2 ;
+  int arg3 ;
+  double arg4 ;
+  double arg5 ;
+  double arg6 ;
+  double arg7 ;
+  double arg8 ;
+  double arg9 ;
+  double arg10 ;
+  double arg11 ;
+  double arg12 ;
+  bool result;
   
   (void)jenv;
   (void)jcls;
   (void)jarg1_;
   arg1 = *(MutualCalibration **)&jarg1; 
-  if (!SWIG_JavaArrayInDouble(jenv, &jarr2, &arg2, jarg2)) return ; 
-  ((MutualCalibration const *)arg1)->getCameraMatrix(arg2);
+  arg2 = (int)jarg2; 
+  arg3 = (int)jarg3; 
+  arg4 = (double)jarg4; 
+  arg5 = (double)jarg5; 
+  arg6 = (double)jarg6; 
+  arg7 = (double)jarg7; 
+  arg8 = (double)jarg8; 
+  arg9 = (double)jarg9; 
+  arg10 = (double)jarg10; 
+  arg11 = (double)jarg11; 
+  arg12 = (double)jarg12; 
+  result = (bool)(arg1)->setCameraParameters(arg2,arg3,arg4,arg5,arg6,arg7,arg8,arg9,arg10,arg11,arg12);
+  jresult = (jboolean)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1loadCameraParameters(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  char *arg2 = (char *) 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = 0;
+  if (jarg2) {
+    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
+    if (!arg2) return 0;
+  }
+  result = (bool)(arg1)->loadCameraParameters((char const *)arg2);
+  jresult = (jboolean)result; 
+  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setLogLevel(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  int arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = (int)jarg2; 
+  (arg1)->setLogLevel(arg2);
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1startFramePipeline(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  result = (bool)(arg1)->startFramePipeline();
+  jresult = (jboolean)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1stopFramePipeline(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  (arg1)->stopFramePipeline();
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1enqueueFrame(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jlong jarg2, jlong jarg3, jint jarg4, jdouble jarg5, jdouble jarg6, jdouble jarg7) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  cv::Mat *arg2 = 0 ;
+  cv::Mat *arg3 = 0 ;
+  int arg4 ;
+  double arg5 ;
+  double arg6 ;
+  double arg7 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = *(cv::Mat **)&jarg2;
+  if (!arg2) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException, "cv::Mat & reference is null");
+    return 0;
+  } 
+  arg3 = *(cv::Mat **)&jarg3;
+  if (!arg3) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException, "cv::Mat & reference is null");
+    return 0;
+  } 
+  arg4 = (int)jarg4; 
+  arg5 = (double)jarg5; 
+  arg6 = (double)jarg6; 
+  arg7 = (double)jarg7; 
+  result = (bool)(arg1)->enqueueFrame(*arg2,*arg3,arg4,arg5,arg6,arg7);
+  jresult = (jboolean)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1enqueueNV21Frame(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jbyteArray jarg2, jint jarg4, jdouble jarg5, jdouble jarg6, jdouble jarg7) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  char *arg2 = (char *) 0 ;
+  size_t arg3 ;
+  int arg4 ;
+  double arg5 ;
+  double arg6 ;
+  double arg7 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  {
+    arg2 = (char *) jenv->GetByteArrayElements(jarg2, 0); 
+    if (!arg2) return 0; 
+    arg3 = (size_t) jenv->GetArrayLength(jarg2); 
+  }
+  arg4 = (int)jarg4; 
+  arg5 = (double)jarg5; 
+  arg6 = (double)jarg6; 
+  arg7 = (double)jarg7; 
+  result = (bool)(arg1)->enqueueNV21Frame(arg2,arg3,arg4,arg5,arg6,arg7);
+  jresult = (jboolean)result; 
+  {
+    jenv->ReleaseByteArrayElements(jarg2, (jbyte *) arg2, JNI_ABORT); 
+  }
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1enqueueTimedNV21Frame(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jbyteArray jarg2, jint jarg4, jlong jarg5, jdouble jarg6, jdouble jarg7, jdouble jarg8) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  char *arg2 = (char *) 0 ;
+  size_t arg3 ;
+  int arg4 ;
+  long long arg5 ;
+  double arg6 ;
+  double arg7 ;
+  double arg8 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  {
+    arg2 = (char *) jenv->GetByteArrayElements(jarg2, 0); 
+    if (!arg2) return 0; 
+    arg3 = (size_t) jenv->GetArrayLength(jarg2); 
+  }
+  arg4 = (int)jarg4; 
+  arg5 = (long long)jarg5; 
+  arg6 = (double)jarg6; 
+  arg7 = (double)jarg7; 
+  arg8 = (double)jarg8; 
+  result = (bool)(arg1)->enqueueTimedNV21Frame(arg2,arg3,arg4,arg5,arg6,arg7,arg8);
+  jresult = (jboolean)result; 
+  {
+    jenv->ReleaseByteArrayElements(jarg2, (jbyte *) arg2, JNI_ABORT); 
+  }
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1pollFrameResult(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jlong jarg2) {
+  jint jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  cv::Mat *arg2 = 0 ;
+  int result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = *(cv::Mat **)&jarg2;
+  if (!arg2) {
+    SWIG_JavaThrowException(jenv, SWIG_JavaNullPointerException, "cv::Mat & reference is null");
+    return 0;
+  } 
+  result = (int)(arg1)->pollFrameResult(*arg2);
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getFramePipelineStats(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdoubleArray jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  double *arg2 ;
+  jdouble *jarr2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  if (!SWIG_JavaArrayInDouble(jenv, &jarr2, &arg2, jarg2)) return ; 
+  ((MutualCalibration const *)arg1)->getFramePipelineStats(arg2);
+  SWIG_JavaArrayArgoutDouble(jenv, jarr2, arg2, jarg2); 
+  delete [] arg2; 
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setSquareSize(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jfloat jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  float arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = (float)jarg2; 
+  (arg1)->setSquareSize(arg2);
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setBoardsPerFrame(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  int arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = (int)jarg2; 
+  (arg1)->setBoardsPerFrame(arg2);
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1addBoardSize(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2, jint jarg3) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  int arg2 ;
+  int arg3 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = (int)jarg2; 
+  arg3 = (int)jarg3; 
+  (arg1)->addBoardSize(arg2,arg3);
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setPartialBoards(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jboolean jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  bool arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = jarg2 ? true : false; 
+  (arg1)->setPartialBoards(arg2);
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setKeyframeSelection(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jboolean jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  bool arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = jarg2 ? true : false; 
+  (arg1)->setKeyframeSelection(arg2);
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getKeyframeStats(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdoubleArray jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  double *arg2 ;
+  jdouble *jarr2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  if (!SWIG_JavaArrayInDouble(jenv, &jarr2, &arg2, jarg2)) return ; 
+  ((MutualCalibration const *)arg1)->getKeyframeStats(arg2);
+  SWIG_JavaArrayArgoutDouble(jenv, jarr2, arg2, jarg2); 
+  delete [] arg2; 
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setIncrementalIntrinsics(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jboolean jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  bool arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = jarg2 ? true : false; 
+  (arg1)->setIncrementalIntrinsics(arg2);
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getOnlineCameraMatrix(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdoubleArray jarg2) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  double *arg2 ;
+  jdouble *jarr2 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  if (!SWIG_JavaArrayInDouble(jenv, &jarr2, &arg2, jarg2)) return 0; 
+  result = (bool)((MutualCalibration const *)arg1)->getOnlineCameraMatrix(arg2);
+  jresult = (jboolean)result; 
+  SWIG_JavaArrayArgoutDouble(jenv, jarr2, arg2, jarg2); 
+  delete [] arg2; 
+  return jresult;
+}
+
+
+SWIGEXPORT jdouble JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getOnlineReprojectionError(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jdouble jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  double result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  result = (double)((MutualCalibration const *)arg1)->getOnlineReprojectionError();
+  jresult = (jdouble)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setViewErrorThreshold(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdouble jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  double arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = (double)jarg2; 
+  (arg1)->setViewErrorThreshold(arg2);
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getViewRefinementStats(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdoubleArray jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  double *arg2 ;
+  jdouble *jarr2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  if (!SWIG_JavaArrayInDouble(jenv, &jarr2, &arg2, jarg2)) return ; 
+  ((MutualCalibration const *)arg1)->getViewRefinementStats(arg2);
+  SWIG_JavaArrayArgoutDouble(jenv, jarr2, arg2, jarg2); 
+  delete [] arg2; 
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1startSessionLog(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  char *arg2 = (char *) 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = 0;
+  if (jarg2) {
+    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
+    if (!arg2) return 0;
+  }
+  result = (bool)(arg1)->startSessionLog((char const *)arg2);
+  jresult = (jboolean)result; 
+  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1stopSessionLog(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  (arg1)->stopSessionLog();
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1replaySession(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  char *arg2 = (char *) 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = 0;
+  if (jarg2) {
+    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
+    if (!arg2) return 0;
+  }
+  result = (bool)(arg1)->replaySession((char const *)arg2);
+  jresult = (jboolean)result; 
+  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1saveCalibration(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  char *arg2 = (char *) 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = 0;
+  if (jarg2) {
+    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
+    if (!arg2) return 0;
+  }
+  result = (bool)((MutualCalibration const *)arg1)->saveCalibration((char const *)arg2);
+  jresult = (jboolean)result; 
+  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1loadCalibration(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  char *arg2 = (char *) 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = 0;
+  if (jarg2) {
+    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
+    if (!arg2) return 0;
+  }
+  result = (bool)(arg1)->loadCalibration((char const *)arg2);
+  jresult = (jboolean)result; 
+  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1addIMUSamples(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jobject jarg2, jint jarg4) {
+  jint jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  void *arg2 = (void *) 0 ;
+  size_t arg3 ;
+  int arg4 ;
+  int result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  {
+    arg2 = jenv->GetDirectBufferAddress(jarg2); 
+    if (!arg2) {
+      SWIG_JavaThrowException(jenv, SWIG_JavaIllegalArgumentException, "direct ByteBuffer expected"); 
+      return 0; 
+    }
+    arg3 = (size_t) jenv->GetDirectBufferCapacity(jarg2); 
+  }
+  arg4 = (int)jarg4; 
+  result = (int)(arg1)->addIMUSamples(arg2,arg3,arg4);
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1addChessboardCorners(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jobject jarg2, jlong jarg4) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  void *arg2 = (void *) 0 ;
+  size_t arg3 ;
+  long long arg4 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  {
+    arg2 = jenv->GetDirectBufferAddress(jarg2); 
+    if (!arg2) {
+      SWIG_JavaThrowException(jenv, SWIG_JavaIllegalArgumentException, "direct ByteBuffer expected"); 
+      return 0; 
+    }
+    arg3 = (size_t) jenv->GetDirectBufferCapacity(jarg2); 
+  }
+  arg4 = (long long)jarg4; 
+  result = (bool)(arg1)->addChessboardCorners(arg2,arg3,arg4);
+  jresult = (jboolean)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jint JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getChessboardCorners(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jint jarg2, jobject jarg3) {
+  jint jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  int arg2 ;
+  void *arg3 = (void *) 0 ;
+  size_t arg4 ;
+  int result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = (int)jarg2; 
+  {
+    arg3 = jenv->GetDirectBufferAddress(jarg3); 
+    if (!arg3) {
+      SWIG_JavaThrowException(jenv, SWIG_JavaIllegalArgumentException, "direct ByteBuffer expected"); 
+      return 0; 
+    }
+    arg4 = (size_t) jenv->GetDirectBufferCapacity(jarg3); 
+  }
+  result = (int)((MutualCalibration const *)arg1)->getChessboardCorners(arg2,arg3,arg4);
+  jresult = (jint)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getCalibrationResults(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jobject jarg2) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  void *arg2 = (void *) 0 ;
+  size_t arg3 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  {
+    arg2 = jenv->GetDirectBufferAddress(jarg2); 
+    if (!arg2) {
+      SWIG_JavaThrowException(jenv, SWIG_JavaIllegalArgumentException, "direct ByteBuffer expected"); 
+      return 0; 
+    }
+    arg3 = (size_t) jenv->GetDirectBufferCapacity(jarg2); 
+  }
+  result = (bool)((MutualCalibration const *)arg1)->getCalibrationResults(arg2,arg3);
+  jresult = (jboolean)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getFrameState(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jobject jarg2) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  void *arg2 = (void *) 0 ;
+  size_t arg3 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  {
+    arg2 = jenv->GetDirectBufferAddress(jarg2); 
+    if (!arg2) {
+      SWIG_JavaThrowException(jenv, SWIG_JavaIllegalArgumentException, "direct ByteBuffer expected"); 
+      return 0; 
+    }
+    arg3 = (size_t) jenv->GetDirectBufferCapacity(jarg2); 
+  }
+  result = (bool)((MutualCalibration const *)arg1)->getFrameState(arg2,arg3);
+  jresult = (jboolean)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1startFrameRecording(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jstring jarg2) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  char *arg2 = (char *) 0 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = 0;
+  if (jarg2) {
+    arg2 = (char *)jenv->GetStringUTFChars(jarg2, 0);
+    if (!arg2) return 0;
+  }
+  result = (bool)(arg1)->startFrameRecording((char const *)arg2);
+  jresult = (jboolean)result; 
+  if (arg2) jenv->ReleaseStringUTFChars(jarg2, (const char *)arg2);
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1stopFrameRecording(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  (arg1)->stopFrameRecording();
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1recordNV21Frame(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jbyteArray jarg2, jint jarg4, jlong jarg5, jdouble jarg6, jdouble jarg7, jdouble jarg8) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  char *arg2 = (char *) 0 ;
+  size_t arg3 ;
+  int arg4 ;
+  long long arg5 ;
+  double arg6 ;
+  double arg7 ;
+  double arg8 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  {
+    arg2 = (char *) jenv->GetByteArrayElements(jarg2, 0); 
+    if (!arg2) return 0; 
+    arg3 = (size_t) jenv->GetArrayLength(jarg2); 
+  }
+  arg4 = (int)jarg4; 
+  arg5 = (long long)jarg5; 
+  arg6 = (double)jarg6; 
+  arg7 = (double)jarg7; 
+  arg8 = (double)jarg8; 
+  result = (bool)(arg1)->recordNV21Frame(arg2,arg3,arg4,arg5,arg6,arg7,arg8);
+  jresult = (jboolean)result; 
+  {
+    jenv->ReleaseByteArrayElements(jarg2, (jbyte *) arg2, JNI_ABORT); 
+  }
+  return jresult;
+}
+
+
+SWIGEXPORT jlong JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getNumberOfImages(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jlong jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  size_t result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  result = ((MutualCalibration const *)arg1)->getNumberOfImages();
+  jresult = (jlong)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT jdouble JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getFocalConfidence(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jdouble jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  double result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  result = (double)((MutualCalibration const *)arg1)->getFocalConfidence();
+  jresult = (jdouble)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getRotationMatrix(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdoubleArray jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  double *arg2 ;
+  jdouble *jarr2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  if (!SWIG_JavaArrayInDouble(jenv, &jarr2, &arg2, jarg2)) return ; 
+  ((MutualCalibration const *)arg1)->getRotationMatrix(arg2);
+  SWIG_JavaArrayArgoutDouble(jenv, jarr2, arg2, jarg2); 
+  delete [] arg2; 
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1setIncrementalCalibration(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jboolean jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  bool arg2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  arg2 = jarg2 ? true : false; 
+  (arg1)->setIncrementalCalibration(arg2);
+}
+
+
+SWIGEXPORT jboolean JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getOnlineRotationMatrix(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdoubleArray jarg2) {
+  jboolean jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  double *arg2 ;
+  jdouble *jarr2 ;
+  bool result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  if (!SWIG_JavaArrayInDouble(jenv, &jarr2, &arg2, jarg2)) return 0; 
+  result = (bool)((MutualCalibration const *)arg1)->getOnlineRotationMatrix(arg2);
+  jresult = (jboolean)result; 
+  SWIG_JavaArrayArgoutDouble(jenv, jarr2, arg2, jarg2); 
+  delete [] arg2; 
+  return jresult;
+}
+
+
+SWIGEXPORT jdouble JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getOnlineConditioning(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_) {
+  jdouble jresult = 0 ;
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  double result;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  result = (double)((MutualCalibration const *)arg1)->getOnlineConditioning();
+  jresult = (jdouble)result; 
+  return jresult;
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getCameraMatrix(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdoubleArray jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  double *arg2 ;
+  jdouble *jarr2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  if (!SWIG_JavaArrayInDouble(jenv, &jarr2, &arg2, jarg2)) return ; 
+  ((MutualCalibration const *)arg1)->getCameraMatrix(arg2);
+  SWIG_JavaArrayArgoutDouble(jenv, jarr2, arg2, jarg2); 
+  delete [] arg2; 
+}
+
+
+SWIGEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CalibrationJNI_MutualCalibration_1getRansacStats(JNIEnv *jenv, jclass jcls, jlong jarg1, jobject jarg1_, jdoubleArray jarg2) {
+  MutualCalibration *arg1 = (MutualCalibration *) 0 ;
+  double *arg2 ;
+  jdouble *jarr2 ;
+  
+  (void)jenv;
+  (void)jcls;
+  (void)jarg1_;
+  arg1 = *(MutualCalibration **)&jarg1; 
+  if (!SWIG_JavaArrayInDouble(jenv, &jarr2, &arg2, jarg2)) return ; 
+  ((MutualCalibration const *)arg1)->getRansacStats(arg2);
   SWIG_JavaArrayArgoutDouble(jenv, jarr2, arg2, jarg2); 
   delete [] arg2; 
 }
@@ -1,13 +1,11 @@
 
 #include <jni.h>
-#include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
-#include <android/log.h>
 
 #define LOG_TAG "Calibration::Native::Main"
-#define LOGI(...) ((void)__android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__))
 
 #include "Chessboard.h"
+#include "Log.h"
 
 using namespace std;
 using namespace cv;
@@ -28,6 +26,6 @@ JNIEXPORT void JNICALL Java_cvg_sfmPipeline_calibration_CameraView_FindFeatures
     Mat* pMatRgb=(Mat*)addrRgba;
     Size boardSize(6, 9);
     bool crnrsFound = detectCorners(pMatGr, boardSize, pMatRgb, (bool)mode);
-    LOGI("Detect corners %s",(crnrsFound)?"successful":"failed");
+    LOGI(LOG_TAG, "Detect corners %s",(crnrsFound)?"successful":"failed");
 }
 }
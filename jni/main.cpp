@@ -1,9 +1,594 @@
+// desktop driver, build with -DLOG_SHOW_IMAGES=1 for the vanishing point window
+//
+//	main                          vanishing points of b.png
+//	main frames.bin [--realtime]  plays a recording made with
+//	                              MutualCalibration::startFrameRecording, as fast
+//	                              as possible or at the cadence it was recorded at,
+//	                              then times calibrateCamera and mutualCalibrate
+//	main --bench-camera [points]  batched CataCamera projections against the
+//	                              scalar ones, speed and largest difference
+//	main --bench-calibration [n]  loads n calibrations from YAML files and from
+//	                              one mapped binary file
+//	main --bench-rotation [n]     the least squares camera to imu rotation from n
+//	                              views, with cv::Mat samples against cv::Matx
+//	main --bench-intrinsics [n]   n synthetic chessboard views, IncrementalIntrinsics
+//	                              as they come in against one cv::calibrateCamera,
+//	                              time and distance to the true intrinsics
+//	main --bench-views [n]        n synthetic chessboard views, memory of the
+//	                              object points and of MutualCalibration, and the
+//	                              time of calibrateCamera
+//	main --bench-histogram [n]    the theta histogram of Cas1DVanishingPoint on n
+//	                              random inputs, cv::calcHist against Histogram1D,
+//	                              speed and whether the peak and support agree
+#include "CalibrationFile.h"
+#include "CataCamera.h"
 #include "RansacVanishingPoint.h"
+#include "MutualCalibration.h"
+#include "FrameRecorder.h"
+#include "Histogram1D.h"
+#include "IncrementalIntrinsics.h"
+#include "Log.h"
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
 #include <opencv2/imgproc/imgproc.hpp>
 #include <opencv2/highgui/highgui.hpp>
-#include <iostream>
-int main()
+#include <opencv2/calib3d/calib3d.hpp>
+
+// resident memory of the process, linux only
+double
+residentKilobytes()
+{
+	long pages = 0, resident = 0; 
+	FILE * file = fopen("/proc/self/statm", "r"); 
+	if (!file) return 0; 
+	if (fscanf(file, "%ld %ld", &pages, &resident) != 2) resident = 0; 
+	fclose(file); 
+	return resident * (sysconf(_SC_PAGESIZE) / 1024.0); 
+}
+
+int
+playback(const char * path, bool realTime)
+{
+	FramePlayback playback; 
+	if (!playback.open(path))
+	{
+		LOGE("main", "could not open %s", path); 
+		return 1; 
+	}
+
+	const FrameFileHeader & header = playback.getHeader(); 
+	bool gravity = (header.flags & FRAME_FILE_GRAVITY) != 0; 
+	MutualCalibration calibration(header.height, header.width, header.boardHeight, header.boardWidth, true, gravity); 
+	calibration.setOverlayDrawing(false); 
+
+	size_t accepted = 0; 
+	double detection = 0; 
+	int64 start = cv::getTickCount(); 
+	PlaybackFrame frame, first; 
+	playback.getFrame(0, first); 
+	for (size_t i = 0; playback.getFrame(i, frame); i++)
+	{
+		if (realTime)
+		{
+			double due = (frame.timestamp - first.timestamp) * 1e-9; 
+			double now = (cv::getTickCount() - start) / cv::getTickFrequency(); 
+			if (due > now) usleep((useconds_t)((due - now) * 1e6)); 
+		}
+
+		// the frame is used in place from the mapping
+		int64 tick = cv::getTickCount(); 
+		cv::Mat output; 
+		bool success = frame.mode == PIPELINE_MODE_CHESSBOARD
+			? calibration.tryAddingChessboardImage(frame.image, output)
+			: calibration.tryAddingVanishingPointImage(frame.image, output); 
+		detection += (cv::getTickCount() - tick) * 1000.0 / cv::getTickFrequency(); 
+
+		if (success)
+		{
+			if (gravity)
+				calibration.addIMUGravityVector(frame.sensor[0], frame.sensor[1], frame.sensor[2]); 
+			else
+				calibration.addFullIMURotationByQuaternion(frame.sensor[0], frame.sensor[1], frame.sensor[2]); 
+			accepted++; 
+		}
+	}
+
+	size_t frames = playback.getNumberOfFrames(); 
+	LOGI("main", "%d frames, %d accepted, %.2f ms detection per frame",
+		 (int)frames, (int)accepted, frames > 0 ? detection / frames : 0.0); 
+
+	if (accepted >= 3)
+	{
+		int64 tick = cv::getTickCount(); 
+		calibration.calibrateCamera(); 
+		double calibrateMilliseconds = (cv::getTickCount() - tick) * 1000.0 / cv::getTickFrequency(); 
+		double views[5]; 
+		calibration.getViewRefinementStats(views); 
+		LOGI("main", "%.0f views refined on %.0f threads in %.2f ms, %.0f excluded, %.3f px rms", 
+			 views[0], views[2], views[4], views[1], views[3]); 
+		double R[9]; 
+		tick = cv::getTickCount(); 
+		bool wellPosed = calibration.mutualCalibrate(); 
+		double mutualMilliseconds = (cv::getTickCount() - tick) * 1000.0 / cv::getTickFrequency(); 
+		// how the calibration scales with the number of views
+		LOGI("main", "%d views: calibrateCamera %.2f ms, mutualCalibrate %.2f ms, %.0f kB resident", 
+			 (int)accepted, calibrateMilliseconds, mutualMilliseconds, residentKilobytes()); 
+		calibration.getRotationMatrix(R); 
+		// columnwise, as stored by getRotationMatrix
+		LOGI("main", "camera to imu%s\n%f %f %f\n%f %f %f\n%f %f %f", wellPosed ? "" : " (ill-posed)",
+			 R[0], R[3], R[6], R[1], R[4], R[7], R[2], R[5], R[8]); 
+	}
+	return 0; 
+}
+
+double
+secondsSince(int64 tick)
+{
+	return (cv::getTickCount() - tick) / cv::getTickFrequency(); 
+}
+
+int
+benchmarkCamera(size_t n)
+{
+	// a wide angle phone lens
+	vcharge::CataCamera camera(vcharge::CataCameraParameters(640, 480, 0.8, -0.2, 0.05, 0.001, -0.002, 900, 905, 322, 238)); 
+	cv::RNG rng; 
+	std::vector<float> uv(2 * n), xyz(3 * n), uvBatch(2 * n); 
+	std::vector<cv::Point3d> xyzScalar(n); 
+	std::vector<cv::Point2d> uvScalar(n); 
+	for (size_t i = 0; i < n; i++)
+	{
+		uv[2 * i] = rng.uniform(0.0f, 640.0f); 
+		uv[2 * i + 1] = rng.uniform(0.0f, 480.0f); 
+	}
+
+	int64 tick = cv::getTickCount(); 
+	for (size_t i = 0; i < n; i++)
+		camera.liftProjective(cv::Point2d(uv[2 * i], uv[2 * i + 1]), xyzScalar[i]); 
+	double liftScalar = secondsSince(tick); 
+	tick = cv::getTickCount(); 
+	camera.liftProjective(&uv[0], &xyz[0], n); 
+	double liftBatch = secondsSince(tick); 
+
+	tick = cv::getTickCount(); 
+	for (size_t i = 0; i < n; i++)
+		camera.spaceToPlane(xyzScalar[i], uvScalar[i]); 
+	double projectScalar = secondsSince(tick); 
+	tick = cv::getTickCount(); 
+	camera.spaceToPlane(&xyz[0], &uvBatch[0], n); 
+	double projectBatch = secondsSince(tick); 
+
+	// the batched results against the scalar ones, in double
+	double liftError = 0, projectError = 0; 
+	for (size_t i = 0; i < n; i++)
+	{
+		liftError = std::max(liftError, std::abs(xyz[3 * i] - xyzScalar[i].x)); 
+		liftError = std::max(liftError, std::abs(xyz[3 * i + 1] - xyzScalar[i].y)); 
+		liftError = std::max(liftError, std::abs(xyz[3 * i + 2] - xyzScalar[i].z)); 
+		projectError = std::max(projectError, std::abs(uvBatch[2 * i] - uvScalar[i].x)); 
+		projectError = std::max(projectError, std::abs(uvBatch[2 * i + 1] - uvScalar[i].y)); 
+	}
+
+	LOGI("main", "%d points, %s kernels", (int)n, vcharge::CataCamera::simdName()); 
+	LOGI("main", "liftProjective: scalar %.2f Mpts/s, batched %.2f Mpts/s, largest difference %g", 
+		 n / liftScalar * 1e-6, n / liftBatch * 1e-6, liftError); 
+	LOGI("main", "spaceToPlane: scalar %.2f Mpts/s, batched %.2f Mpts/s, largest difference %g px", 
+		 n / projectScalar * 1e-6, n / projectBatch * 1e-6, projectError); 
+	return 0; 
+}
+
+int
+benchmarkCalibrationFiles(size_t n)
+{
+	if (n == 0) return 1; 
+	char folder[] = "/tmp/calibrationXXXXXX"; 
+	if (!mkdtemp(folder))
+	{
+		LOGE("main", "could not create a temporary folder"); 
+		return 1; 
+	}
+	std::string binary = std::string(folder) + "/calibrations.bin"; 
+	std::vector<std::string> yaml(n); 
+	std::vector<CalibrationRecord> records(n); 
+	for (size_t i = 0; i < n; i++)
+	{
+		// a different device for each
+		vcharge::CataCameraParameters parameters(640, 480, 0.8, -0.2, 0.05, 0.001, -0.002, 900, 905, 300 + i % 40, 238); 
+		char name[32]; 
+		snprintf(name, sizeof(name), "/%06d.yaml", (int)i); 
+		yaml[i] = folder + std::string(name); 
+		parameters.write(yaml[i]); 
+		records[i] = createCalibrationRecord(640, 480); 
+		setCataParameters(records[i], parameters); 
+		sealCalibrationRecord(records[i]); 
+	}
+	writeCalibrationFile(binary.c_str(), &records[0], n); 
+
+	int64 tick = cv::getTickCount(); 
+	size_t yamlLoaded = 0; 
+	for (size_t i = 0; i < n; i++)
+	{
+		vcharge::CataCameraParameters parameters; 
+		if (parameters.read(yaml[i])) yamlLoaded++; 
+	}
+	double yamlSeconds = secondsSince(tick); 
+
+	tick = cv::getTickCount(); 
+	size_t binaryLoaded = 0; 
+	CalibrationFileReader reader; 
+	if (reader.open(binary.c_str()))
+	{
+		for (size_t i = 0; i < reader.getNumberOfRecords(); i++)
+		{
+			vcharge::CataCameraParameters parameters; 
+			const CalibrationRecord * record = reader.getRecord(i); 
+			if (record && getCataParameters(*record, parameters)) binaryLoaded++; 
+		}
+	}
+	reader.close(); 
+	double binarySeconds = secondsSince(tick); 
+
+	LOGI("main", "yaml: %d of %d loaded in %.2f ms, %.2f us each", 
+		 (int)yamlLoaded, (int)n, yamlSeconds * 1e3, yamlSeconds * 1e6 / n); 
+	LOGI("main", "binary: %d of %d loaded in %.2f ms, %.3f us each, crc checked, %.0fx faster", 
+		 (int)binaryLoaded, (int)n, binarySeconds * 1e3, binarySeconds * 1e6 / n, yamlSeconds / binarySeconds); 
+
+	for (size_t i = 0; i < n; i++)
+		unlink(yaml[i].c_str()); 
+	unlink(binary.c_str()); 
+	rmdir(folder); 
+	return 0; 
+}
+
+// the gravity pairing and least squares rotation as computed when the
+// samples were stored as cv::Mat
+cv::Mat
+matCameraGravity(const cv::Mat & ideal, const cv::Mat & cameraRotation, const cv::Mat & imuGravity)
+{
+	cv::Mat R_c2i = ideal * cameraRotation; 
+	cv::Mat gCamera = R_c2i.col(0) * 1.0; 
+	for (int i = 0; i < 3; i++)
+	{
+		if (i > 0 && cv::norm(imuGravity - R_c2i.col(i)) < cv::norm(imuGravity - gCamera))
+			gCamera = R_c2i.col(i) * 1.0; 
+		if (cv::norm(imuGravity + R_c2i.col(i)) < cv::norm(imuGravity - gCamera))
+			gCamera = -R_c2i.col(i) * 1.0; 
+	}
+	return ideal.t() * gCamera * 1.0; 
+}
+
+bool
+matMutualCalibrate(const cv::Mat & ideal, const std::vector<cv::Mat> & rotations, const std::vector<cv::Mat> & imuGravity, cv::Mat & outputRotation)
+{
+	std::vector<cv::Mat> cameraGravity; 
+	for (size_t i = 0; i < rotations.size(); i++)
+		cameraGravity.push_back(matCameraGravity(ideal, rotations[i], imuGravity[i])); 
+
+	cv::Mat S(3, cameraGravity.size(), CV_64F); 
+	cv::Mat T(3, cameraGravity.size(), CV_64F); 
+	for (size_t i = 0; i < cameraGravity.size(); i++)
+	{
+		S.col(i) = cameraGravity[i] * 1.0; 
+		T.col(i) = imuGravity[i] * 1.0; 
+	}
+	cv::Mat A = T * S.t(); 
+	cv::Mat D, U, Vt; 
+	cv::SVD::compute(A, D, U, Vt); 
+	outputRotation = U * Vt; 
+	return D.at<double>(1) / D.at<double>(0) >= 0.01; 
+}
+
+// the protected solver steps of MutualCalibration, on given samples
+class RotationSolver : public MutualCalibration
+{
+public: 
+	RotationSolver() : MutualCalibration(480, 640, 6, 9) {}
+
+	cv::Matx33d alignment() const { return createAlignmentMatrix(); }
+
+	bool solve(const std::vector<cv::Matx33d> & rotations, const std::vector<cv::Vec3d> & imuGravity, cv::Matx33d & outputRotation) const
+	{
+		return lsMutualCalibrateWithHorizontalChessboard(findCameraGravity(rotations, imuGravity), imuGravity, outputRotation); 
+	}
+}; 
+
+int
+benchmarkRotation(size_t n)
+{
+	if (n < 3) return 1; 
+	const int repeats = 20; 
+	RotationSolver solver; 
+	cv::Mat ideal(solver.alignment()); 
+	cv::Mat camera2IMU; 
+	cv::Rodrigues(cv::Mat(cv::Vec3d(0.02, -0.03, 0.01)), camera2IMU); 
+
+	// random board orientations, the imu sees the board normal through the
+	// unknown rotation plus some noise
+	cv::RNG rng; 
+	std::vector<cv::Matx33d> rotations(n); 
+	std::vector<cv::Vec3d> imuGravity(n); 
+	std::vector<cv::Mat> matRotations(n), matGravity(n); 
+	for (size_t i = 0; i < n; i++)
+	{
+		cv::Mat R; 
+		cv::Rodrigues(cv::Mat(cv::Vec3d(rng.uniform(-1.0, 1.0), rng.uniform(-1.0, 1.0), rng.uniform(-1.0, 1.0))), R); 
+		cv::Mat g = camera2IMU * ideal.t() * (ideal * R).col(2); 
+		cv::Vec3d noise(rng.gaussian(0.01), rng.gaussian(0.01), rng.gaussian(0.01)); 
+		rotations[i] = cv::Matx33d(R); 
+		imuGravity[i] = cv::normalize(cv::Vec3d(g) + noise); 
+		matRotations[i] = R; 
+		matGravity[i] = cv::Mat(imuGravity[i]) * 1.0; 
+	}
+
+	cv::Mat matRotation; 
+	int64 tick = cv::getTickCount(); 
+	for (int r = 0; r < repeats; r++)
+		matMutualCalibrate(ideal, matRotations, matGravity, matRotation); 
+	double matSeconds = secondsSince(tick) / repeats; 
+
+	cv::Matx33d rotation; 
+	tick = cv::getTickCount(); 
+	for (int r = 0; r < repeats; r++)
+		solver.solve(rotations, imuGravity, rotation); 
+	double matxSeconds = secondsSince(tick) / repeats; 
+
+	LOGI("main", "%d views: cv::Mat %.3f ms, cv::Matx %.3f ms per solve, %.1fx faster", 
+		 (int)n, matSeconds * 1e3, matxSeconds * 1e3, matSeconds / matxSeconds); 
+	LOGI("main", "largest difference between the two %g, error against the truth %g", 
+		 cv::norm(matRotation - cv::Mat(rotation), cv::NORM_INF), cv::norm(camera2IMU - cv::Mat(rotation), cv::NORM_INF)); 
+	return 0; 
+}
+
+// a 640x480 camera with some radial distortion
+void
+createSyntheticCamera(cv::Matx33d & K, cv::Mat & distortion)
+{
+	K = cv::Matx33d(520, 0, 318, 0, 523, 242, 0, 0, 1); 
+	distortion = cv::Mat::zeros(5, 1, CV_64F); 
+	distortion.at<double>(0) = 0.12; 
+	distortion.at<double>(1) = -0.25; 
+}
+
+// a 9x6 board of 25 mm squares, row by row as MutualCalibration builds it
+std::vector<cv::Point3f>
+createSyntheticBoard()
+{
+	std::vector<cv::Point3f> board; 
+	for (int i = 0; i < 6; i++)
+		for (int j = 0; j < 9; j++)
+			board.push_back(cv::Point3f(j * 0.025f, i * 0.025f, 0)); 
+	return board; 
+}
+
+// the board seen from n random poses in front of the camera, all corners
+// inside the image, with 0.2 px of corner noise
+void
+createSyntheticViews(const std::vector<cv::Point3f> & board, const cv::Matx33d & K, const cv::Mat & distortion, 
+					 cv::Size imageSize, size_t n, std::vector<std::vector<cv::Point2f> > & imagePoints)
+{
+	cv::RNG rng; 
+	imagePoints.clear(); 
+	while (imagePoints.size() < n)
+	{
+		cv::Vec3d rvec(rng.uniform(-0.5, 0.5), rng.uniform(-0.5, 0.5), rng.uniform(-0.3, 0.3)); 
+		cv::Vec3d tvec(rng.uniform(-0.15, -0.05), rng.uniform(-0.11, -0.01), rng.uniform(0.3, 0.6)); 
+		std::vector<cv::Point2f> corners; 
+		cv::projectPoints(board, cv::Mat(rvec), cv::Mat(tvec), cv::Mat(K), distortion, corners); 
+		bool inside = true; 
+		for (size_t k = 0; k < corners.size(); k++)
+		{
+			corners[k].x += rng.gaussian(0.2); 
+			corners[k].y += rng.gaussian(0.2); 
+			inside = inside && corners[k].x >= 0 && corners[k].x < imageSize.width
+				&& corners[k].y >= 0 && corners[k].y < imageSize.height; 
+		}
+		if (inside) imagePoints.push_back(corners); 
+	}
+}
+
+void
+logIntrinsics(const char * name, const cv::Mat & K, const cv::Mat & distortion, double seconds)
+{
+	LOGI("main", "%s: %.2f ms, fx %.2f fy %.2f cx %.2f cy %.2f k1 %.4f k2 %.4f", name, seconds * 1e3, 
+		 K.at<double>(0, 0), K.at<double>(1, 1), K.at<double>(0, 2), K.at<double>(1, 2), 
+		 distortion.at<double>(0), distortion.at<double>(1)); 
+}
+
+int
+benchmarkIntrinsics(size_t n)
+{
+	if (n < 3) return 1; 
+	cv::Size imageSize(640, 480); 
+	cv::Matx33d K; 
+	cv::Mat distortion; 
+	createSyntheticCamera(K, distortion); 
+	std::vector<cv::Point3f> board = createSyntheticBoard(); 
+	std::vector<std::vector<cv::Point2f> > imagePoints; 
+	createSyntheticViews(board, K, distortion, imageSize, n, imagePoints); 
+	std::vector<std::vector<cv::Point3f> > objectPoints(n, board); 
+
+	// the incremental update is paid per view, while the views come in
+	IncrementalIntrinsics intrinsics(imageSize); 
+	double slowest = 0; 
+	int64 tick = cv::getTickCount(); 
+	for (size_t i = 0; i < n; i++)
+	{
+		int64 viewTick = cv::getTickCount(); 
+		intrinsics.addView(objectPoints[i], imagePoints[i]); 
+		slowest = std::max(slowest, secondsSince(viewTick)); 
+	}
+	double incrementalSeconds = secondsSince(tick); 
+
+	// the batch calibration is paid at once when calibrateCamera is called
+	cv::Mat batchK, batchDistortion; 
+	std::vector<cv::Mat> rvecs, tvecs; 
+	tick = cv::getTickCount(); 
+	double batchRMS = cv::calibrateCamera(objectPoints, imagePoints, imageSize, batchK, batchDistortion, rvecs, tvecs); 
+	double batchSeconds = secondsSince(tick); 
+
+	LOGI("main", "%d views, truth fx %.2f fy %.2f cx %.2f cy %.2f k1 %.4f k2 %.4f", (int)n, 
+		 K(0, 0), K(1, 1), K(0, 2), K(1, 2), distortion.at<double>(0), distortion.at<double>(1)); 
+	if (!intrinsics.available())
+	{
+		LOGE("main", "the incremental intrinsics are not available"); 
+		return 1; 
+	}
+	logIntrinsics("cv::calibrateCamera", batchK, batchDistortion, batchSeconds); 
+	logIntrinsics("IncrementalIntrinsics", intrinsics.getCameraMatrix(), intrinsics.getDistortion(), incrementalSeconds); 
+	LOGI("main", "incremental: %.3f ms per view, %.3f ms at most, %.3f px rms over the window; batch %.3f px rms", 
+		 incrementalSeconds * 1e3 / n, slowest * 1e3, intrinsics.getRMS(), batchRMS); 
+	return 0; 
+}
+
+int
+benchmarkViews(size_t n)
+{
+	if (n < 3) return 1; 
+	cv::Size imageSize(640, 480); 
+	cv::Matx33d K; 
+	cv::Mat distortion; 
+	createSyntheticCamera(K, distortion); 
+	std::vector<cv::Point3f> board = createSyntheticBoard(); 
+	std::vector<std::vector<cv::Point2f> > imagePoints; 
+	createSyntheticViews(board, K, distortion, imageSize, n, imagePoints); 
+
+	// the object points handed to cv::calibrateCamera, one header per view on
+	// a shared board against a copy of the board per view; the shared ones
+	// first, freed memory is not always given back
+	double resident = residentKilobytes(); 
+	std::vector<cv::Mat> shared(n, cv::Mat(board)); 
+	double sharedKilobytes = residentKilobytes() - resident; 
+	resident = residentKilobytes(); 
+	std::vector<std::vector<cv::Point3f> > copies(n, board); 
+	double copiesKilobytes = residentKilobytes() - resident; 
+	LOGI("main", "%d views of %d corners, object points: shared %.0f kB resident, %.0f kB of headers; copies %.0f kB resident, %.0f kB of points", 
+		 (int)n, (int)board.size(), sharedKilobytes, n * sizeof(cv::Mat) / 1024.0, 
+		 copiesKilobytes, n * board.size() * sizeof(cv::Point3f) / 1024.0); 
+
+	// the same views through MutualCalibration
+	MutualCalibration calibration(imageSize.height, imageSize.width, 6, 9); 
+	calibration.setSquareSize(0.025f); 
+	resident = residentKilobytes(); 
+	int64 tick = cv::getTickCount(); 
+	for (size_t i = 0; i < n; i++)
+		calibration.addChessboardCorners(&imagePoints[i][0], imagePoints[i].size() * sizeof(cv::Point2f), -1); 
+	double addSeconds = secondsSince(tick); 
+	double addKilobytes = residentKilobytes() - resident; 
+	tick = cv::getTickCount(); 
+	calibration.calibrateCamera(); 
+	double calibrateSeconds = secondsSince(tick); 
+	double calibrateKilobytes = residentKilobytes() - resident - addKilobytes; 
+
+	double views[5]; 
+	calibration.getViewRefinementStats(views); 
+	LOGI("main", "MutualCalibration: %d views added in %.2f ms, %.0f kB; calibrateCamera %.2f ms, %.0f kB more, %.3f px rms", 
+		 (int)calibration.getNumberOfImages(), addSeconds * 1e3, addKilobytes, calibrateSeconds * 1e3, calibrateKilobytes, views[3]); 
+	return 0; 
+}
+
+// the findTheta peak and support as computed before Histogram1D
+float
+calcHistTheta(const std::vector<float> & thetas, float threshold, std::vector<size_t> & supportIndex)
 {
+	int channel = 0; 
+	int histSize = std::max((int)thetas.size() / 2, 90); 
+	float histRange[] = {-CV_PI, CV_PI}; 
+	const float *histRanges[] = {histRange}; 
+	cv::Mat data(thetas); 
+	cv::Mat hist; 
+	cv::calcHist(&data, 1, &channel, cv::Mat(), hist, 1, &histSize, histRanges, true, false); 
+
+	cv::Point max_loc; 
+	cv::minMaxLoc(hist, NULL, NULL, NULL, &max_loc); 
+	float theta = histRange[0] + max_loc.y * (histRange[1] - histRange[0]) / histSize; 
+	for (size_t i = 0; i < thetas.size(); i++)
+	{
+		if (fabs(thetas[i] - theta) < threshold || 2.0f * CV_PI - fabs(thetas[i] - theta) < threshold)
+			supportIndex.push_back(i); 
+	}
+	return theta; 
+}
+
+float
+histogram1DTheta(const std::vector<float> & thetas, float threshold, std::vector<size_t> & supportIndex)
+{
+	int histSize = std::max((int)thetas.size() / 2, 90); 
+	Histogram1D hist(-CV_PI, CV_PI, histSize, true); 
+	float theta = hist.binLower(hist.vote(thetas)); 
+	hist.support(theta, threshold, supportIndex); 
+	return theta; 
+}
+
+int
+benchmarkHistogram(size_t n)
+{
+	if (n == 0) return 1; 
+	float threshold = 5.0f / 360 * CV_PI; 
+	cv::RNG rng; 
+	std::vector<std::vector<float> > inputs(n); 
+	for (size_t i = 0; i < n; i++)
+	{
+		// line directions of a frame: a few dominant ones, some wrapping
+		// around +-pi, and clutter
+		int lines = rng.uniform(20, 400); 
+		int modes = rng.uniform(1, 4); 
+		float mode[3]; 
+		for (int m = 0; m < modes; m++) mode[m] = rng.uniform(-CV_PI, CV_PI); 
+		for (int l = 0; l < lines; l++)
+		{
+			float theta = rng.uniform(0.0, 1.0) < 0.3
+				? rng.uniform(-CV_PI, CV_PI)
+				: mode[rng.uniform(0, modes)] + rng.gaussian(0.03); 
+			if (theta >= CV_PI) theta -= 2 * CV_PI; 
+			if (theta < -CV_PI) theta += 2 * CV_PI; 
+			inputs[i].push_back(theta); 
+		}
+	}
+
+	std::vector<float> calcHistPeak(n), histogramPeak(n); 
+	std::vector<std::vector<size_t> > calcHistSupport(n), histogramSupport(n); 
+	int64 tick = cv::getTickCount(); 
+	for (size_t i = 0; i < n; i++)
+		calcHistPeak[i] = calcHistTheta(inputs[i], threshold, calcHistSupport[i]); 
+	double calcHistSeconds = secondsSince(tick); 
+	tick = cv::getTickCount(); 
+	for (size_t i = 0; i < n; i++)
+		histogramPeak[i] = histogram1DTheta(inputs[i], threshold, histogramSupport[i]); 
+	double histogramSeconds = secondsSince(tick); 
+
+	size_t peakMismatch = 0, supportMismatch = 0; 
+	for (size_t i = 0; i < n; i++)
+	{
+		if (calcHistPeak[i] != histogramPeak[i]) peakMismatch++; 
+		if (calcHistSupport[i] != histogramSupport[i]) supportMismatch++; 
+	}
+
+	LOGI("main", "%d inputs: calcHist %.2f us, Histogram1D %.2f us per input, %.1fx faster", 
+		 (int)n, calcHistSeconds * 1e6 / n, histogramSeconds * 1e6 / n, calcHistSeconds / histogramSeconds); 
+	LOGI("main", "%d peaks and %d support sets differ", (int)peakMismatch, (int)supportMismatch); 
+	return peakMismatch == 0 && supportMismatch == 0 ? 0 : 1; 
+}
+
+int main(int argc, char ** argv)
+{
+	if (argc > 1 && strcmp(argv[1], "--bench-calibration") == 0)
+		return benchmarkCalibrationFiles(argc > 2 ? atoi(argv[2]) : 1000); 
+	if (argc > 1 && strcmp(argv[1], "--bench-rotation") == 0)
+		return benchmarkRotation(argc > 2 ? atoi(argv[2]) : 5000); 
+	if (argc > 1 && strcmp(argv[1], "--bench-intrinsics") == 0)
+		return benchmarkIntrinsics(argc > 2 ? atoi(argv[2]) : 50); 
+	if (argc > 1 && strcmp(argv[1], "--bench-views") == 0)
+		return benchmarkViews(argc > 2 ? atoi(argv[2]) : 1000); 
+	if (argc > 1 && strcmp(argv[1], "--bench-histogram") == 0)
+		return benchmarkHistogram(argc > 2 ? atoi(argv[2]) : 2000); 
+	if (argc > 1 && strcmp(argv[1], "--bench-camera") == 0)
+		return benchmarkCamera(argc > 2 ? atoi(argv[2]) : 1000000); 
+	if (argc > 1)
+		return playback(argv[1], argc > 2 && strcmp(argv[2], "--realtime") == 0); 
+
 	cv::Mat image = cv::imread("b.png"); 
 //	cv::Mat image = cv::imread("cb.png");
 /*	Cas1DVanishingPoint vp(image); 
@@ -13,7 +598,12 @@ int main()
 	RansacVanishingPoint vp(image); 
 
 	vp.findOrthogonalVanishingPts(); 
-	std::cout << vp.getRotation() << std::endl; 
+	cv::Mat R = vp.getRotation(); 
+	if (!R.empty())
+		LOGI("main", "rotation\n%f %f %f\n%f %f %f\n%f %f %f",
+			 R.at<double>(0, 0), R.at<double>(0, 1), R.at<double>(0, 2),
+			 R.at<double>(1, 0), R.at<double>(1, 1), R.at<double>(1, 2),
+			 R.at<double>(2, 0), R.at<double>(2, 1), R.at<double>(2, 2)); 
 	vp.showVanishing(vp.selectOrthogonalVanishingPts()); 
 	return 0; 
 }
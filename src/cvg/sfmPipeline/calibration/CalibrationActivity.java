@@ -95,6 +95,10 @@ public class CalibrationActivity extends Activity{
 	//--   Sensor readings buffers
     public static float[] latestSensor;
     public static float[] beforeSensor;
+    // last rotation vector reading, for the device rotation between frames
+    public static volatile float[] latestRotationVector;
+    // offset of the sensor event clock, for stamping preview frames
+    public static final SensorClock sensorClock = new SensorClock();
     private SensorManager  mSensorManager;
     private List<Sensor> sensors;
     private List<Integer> logList;
@@ -107,6 +111,9 @@ public class CalibrationActivity extends Activity{
 		super.onPause();
 		mSensorManager.unregisterListener(mSensorEventListener);
 		mSensorEventListener = null;
+		// onResume starts over with a new calibration object and log
+		if (mView.calibrationObject != null)
+			mView.calibrationObject.stopSessionLog();
 		mView.releaseCamera();
 	}
 
@@ -157,8 +164,29 @@ public class CalibrationActivity extends Activity{
 		}
 		
 		setEnabledUI(false);
+		// the pipeline worker must not add images while calibrating
+		mView.calibrationObject.stopFramePipeline();
+		if (mView.MODE_KEYFRAMES) {
+			// considered, kept, rejected
+			double[] keyframes = new double[3];
+			mView.calibrationObject.getKeyframeStats(keyframes);
+			Log.i(TAG, String.format("keyframes: %.0f considered, %.0f kept, %.0f rejected",
+					keyframes[0], keyframes[1], keyframes[2]));
+		}
 		mView.calibrationObject.calibrateCamera();
+		// views, excluded, threads, rms of the kept views, milliseconds
+		double[] views = new double[5];
+		mView.calibrationObject.getViewRefinementStats(views);
+		Log.i(TAG, String.format("views: %.0f refined, %.0f excluded, %.0f threads, %.3f px rms, %.2f ms",
+				views[0], views[1], views[2], views[3], views[4]));
 		boolean wellPosed = mView.calibrationObject.mutualCalibrate();
+		if (mView.MODE_USERANSCA) {
+			// samples, iterations, inliers, milliseconds
+			double[] stats = new double[4];
+			mView.calibrationObject.getRansacStats(stats);
+			Log.i(TAG, String.format("RANSAC: %.0f samples, %.0f iterations, %.0f inliers, %.2f ms",
+					stats[0], stats[1], stats[2], stats[3]));
+		}
 		
 		if (!wellPosed)
 		{
@@ -190,6 +218,9 @@ public class CalibrationActivity extends Activity{
 			saveMatrix(data2, "camMatrix");
 			
 			saveParameters(data2, "calibration");
+			// the same results in one checksummed binary record, see jni/CalibrationFile.h
+			if (!mView.calibrationObject.saveCalibration(mView.getDataFolder() + "/calibration.bin"))
+				Log.e(TAG, "Could not write calibration.bin");
 			
 			mIsCalibrated = true;
 			setEnabledUI(true);
@@ -369,6 +400,18 @@ public class CalibrationActivity extends Activity{
         @Override
         public void onSensorChanged(SensorEvent event) {
         	latestSensor = event.values;
+        	sensorClock.update(event.timestamp);
+        	if (event.sensor.getType() == Sensor.TYPE_ROTATION_VECTOR)
+        		latestRotationVector = event.values.clone();
+        	// timestamped samples of the calibration sensor go to the native ring buffer,
+        	// frames are matched to them by exposure time
+        	if (mView.calibrationObject != null && event.sensor.getType() ==
+        			(mView.MODE_USEONLYIMU ? Sensor.TYPE_GRAVITY : Sensor.TYPE_ROTATION_VECTOR))
+        		if (mView.MODE_BUFFERTRANSFER)
+        			// batched, the preview thread flushes once per frame
+        			mView.imuBatch.add(mView.calibrationObject, event.timestamp, event.values[0], event.values[1], event.values[2]);
+        		else
+        			mView.calibrationObject.addIMUSample(event.timestamp, event.values[0], event.values[1], event.values[2]);
         	Log.e(TAG, "Some values: " + event.values[0]);
         	updateUI(CalibrationActivity.SENSOR_TXT, 0, event);
         }
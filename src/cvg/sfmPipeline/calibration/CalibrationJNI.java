@@ -15,11 +15,62 @@ public class CalibrationJNI {
   public final static native long new_MutualCalibration__SWIG_3(long jarg1, long jarg2, long jarg3, long jarg4);
   public final static native boolean MutualCalibration_tryAddingChessboardImage(long jarg1, MutualCalibration jarg1_, long jarg2, long jarg3);
   public final static native boolean MutualCalibration_tryAddingVanishingPointImage(long jarg1, MutualCalibration jarg1_, long jarg2, long jarg3);
+  public final static native boolean MutualCalibration_tryAddingNV21Image(long jarg1, MutualCalibration jarg1_, byte[] jarg2, int jarg3, long jarg4);
+  public final static native void MutualCalibration_setOverlayDrawing(long jarg1, MutualCalibration jarg1_, boolean jarg2);
+  public final static native long MutualCalibration_getOverlaySize(long jarg1, MutualCalibration jarg1_);
+  public final static native void MutualCalibration_getOverlay(long jarg1, MutualCalibration jarg1_, float[] jarg2);
   public final static native void MutualCalibration_addFullIMURotationByQuaternion(long jarg1, MutualCalibration jarg1_, double jarg2, double jarg3, double jarg4);
   public final static native void MutualCalibration_addIMUGravityVector(long jarg1, MutualCalibration jarg1_, double jarg2, double jarg3, double jarg4);
+  public final static native void MutualCalibration_addIMUSample(long jarg1, MutualCalibration jarg1_, long jarg2, double jarg3, double jarg4, double jarg5);
+  public final static native void MutualCalibration_setIMUTimeConstant(long jarg1, MutualCalibration jarg1_, double jarg2);
+  public final static native boolean MutualCalibration_getIMUAtTimestamp(long jarg1, MutualCalibration jarg1_, long jarg2, double[] jarg3);
+  public final static native void MutualCalibration_setVanishingPointTracking(long jarg1, MutualCalibration jarg1_, boolean jarg2);
+  public final static native void MutualCalibration_setIMURotationDelta(long jarg1, MutualCalibration jarg1_, double jarg2, double jarg3, double jarg4);
+  public final static native void MutualCalibration_setVanishingPointEngine(long jarg1, MutualCalibration jarg1_, int jarg2);
+  public final static native void MutualCalibration_setParallelVanishingPointEngines(long jarg1, MutualCalibration jarg1_, boolean jarg2);
+  public final static native void MutualCalibration_getVanishingPointStats(long jarg1, MutualCalibration jarg1_, double[] jarg2);
+  public final static native boolean MutualCalibration_setCameraParameters(long jarg1, MutualCalibration jarg1_, int jarg2, int jarg3, double jarg4, double jarg5, double jarg6, double jarg7, double jarg8, double jarg9, double jarg10, double jarg11, double jarg12);
+  public final static native boolean MutualCalibration_loadCameraParameters(long jarg1, MutualCalibration jarg1_, String jarg2);
+  public final static native void MutualCalibration_setLogLevel(long jarg1, MutualCalibration jarg1_, int jarg2);
+  public final static native boolean MutualCalibration_startFramePipeline(long jarg1, MutualCalibration jarg1_);
+  public final static native void MutualCalibration_stopFramePipeline(long jarg1, MutualCalibration jarg1_);
+  public final static native boolean MutualCalibration_enqueueFrame(long jarg1, MutualCalibration jarg1_, long jarg2, long jarg3, int jarg4, double jarg5, double jarg6, double jarg7);
+  public final static native boolean MutualCalibration_enqueueNV21Frame(long jarg1, MutualCalibration jarg1_, byte[] jarg2, int jarg3, double jarg4, double jarg5, double jarg6);
+  public final static native boolean MutualCalibration_enqueueTimedNV21Frame(long jarg1, MutualCalibration jarg1_, byte[] jarg2, int jarg3, long jarg4, double jarg5, double jarg6, double jarg7);
+  public final static native int MutualCalibration_pollFrameResult(long jarg1, MutualCalibration jarg1_, long jarg2);
+  public final static native void MutualCalibration_getFramePipelineStats(long jarg1, MutualCalibration jarg1_, double[] jarg2);
+  public final static native void MutualCalibration_setSquareSize(long jarg1, MutualCalibration jarg1_, float jarg2);
+  public final static native void MutualCalibration_setBoardsPerFrame(long jarg1, MutualCalibration jarg1_, int jarg2);
+  public final static native void MutualCalibration_addBoardSize(long jarg1, MutualCalibration jarg1_, int jarg2, int jarg3);
+  public final static native void MutualCalibration_setPartialBoards(long jarg1, MutualCalibration jarg1_, boolean jarg2);
+  public final static native void MutualCalibration_setKeyframeSelection(long jarg1, MutualCalibration jarg1_, boolean jarg2);
+  public final static native void MutualCalibration_getKeyframeStats(long jarg1, MutualCalibration jarg1_, double[] jarg2);
+  public final static native void MutualCalibration_setIncrementalIntrinsics(long jarg1, MutualCalibration jarg1_, boolean jarg2);
+  public final static native boolean MutualCalibration_getOnlineCameraMatrix(long jarg1, MutualCalibration jarg1_, double[] jarg2);
+  public final static native double MutualCalibration_getOnlineReprojectionError(long jarg1, MutualCalibration jarg1_);
+  public final static native void MutualCalibration_setViewErrorThreshold(long jarg1, MutualCalibration jarg1_, double jarg2);
+  public final static native void MutualCalibration_getViewRefinementStats(long jarg1, MutualCalibration jarg1_, double[] jarg2);
+  public final static native boolean MutualCalibration_startSessionLog(long jarg1, MutualCalibration jarg1_, String jarg2);
+  public final static native void MutualCalibration_stopSessionLog(long jarg1, MutualCalibration jarg1_);
+  public final static native boolean MutualCalibration_replaySession(long jarg1, MutualCalibration jarg1_, String jarg2);
+  public final static native boolean MutualCalibration_saveCalibration(long jarg1, MutualCalibration jarg1_, String jarg2);
+  public final static native boolean MutualCalibration_loadCalibration(long jarg1, MutualCalibration jarg1_, String jarg2);
+  public final static native int MutualCalibration_addIMUSamples(long jarg1, MutualCalibration jarg1_, java.nio.ByteBuffer jarg2, int jarg4);
+  public final static native boolean MutualCalibration_addChessboardCorners(long jarg1, MutualCalibration jarg1_, java.nio.ByteBuffer jarg2, long jarg4);
+  public final static native int MutualCalibration_getChessboardCorners(long jarg1, MutualCalibration jarg1_, int jarg2, java.nio.ByteBuffer jarg3);
+  public final static native boolean MutualCalibration_getCalibrationResults(long jarg1, MutualCalibration jarg1_, java.nio.ByteBuffer jarg2);
+  public final static native boolean MutualCalibration_getFrameState(long jarg1, MutualCalibration jarg1_, java.nio.ByteBuffer jarg2);
+  public final static native boolean MutualCalibration_startFrameRecording(long jarg1, MutualCalibration jarg1_, String jarg2);
+  public final static native void MutualCalibration_stopFrameRecording(long jarg1, MutualCalibration jarg1_);
+  public final static native boolean MutualCalibration_recordNV21Frame(long jarg1, MutualCalibration jarg1_, byte[] jarg2, int jarg3, long jarg4, double jarg5, double jarg6, double jarg7);
   public final static native long MutualCalibration_getNumberOfImages(long jarg1, MutualCalibration jarg1_);
+  public final static native double MutualCalibration_getFocalConfidence(long jarg1, MutualCalibration jarg1_);
   public final static native void MutualCalibration_getRotationMatrix(long jarg1, MutualCalibration jarg1_, double[] jarg2);
+  public final static native void MutualCalibration_setIncrementalCalibration(long jarg1, MutualCalibration jarg1_, boolean jarg2);
+  public final static native boolean MutualCalibration_getOnlineRotationMatrix(long jarg1, MutualCalibration jarg1_, double[] jarg2);
+  public final static native double MutualCalibration_getOnlineConditioning(long jarg1, MutualCalibration jarg1_);
   public final static native void MutualCalibration_getCameraMatrix(long jarg1, MutualCalibration jarg1_, double[] jarg2);
+  public final static native void MutualCalibration_getRansacStats(long jarg1, MutualCalibration jarg1_, double[] jarg2);
   public final static native void MutualCalibration_calibrateCamera(long jarg1, MutualCalibration jarg1_);
   public final static native boolean MutualCalibration_mutualCalibrate(long jarg1, MutualCalibration jarg1_);
   public final static native void delete_MutualCalibration(long jarg1);
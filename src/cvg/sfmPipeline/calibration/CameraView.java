@@ -3,6 +3,9 @@ package cvg.sfmPipeline.calibration;
 import java.io.File;
 import java.io.FileNotFoundException;
 import java.io.FileOutputStream;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.DoubleBuffer;
 
 import org.opencv.android.OpenCVLoader;
 import org.opencv.android.Utils;
@@ -12,6 +15,10 @@ import org.opencv.imgproc.Imgproc;
 
 import android.content.Context;
 import android.graphics.Bitmap;
+import android.graphics.Canvas;
+import android.graphics.Color;
+import android.graphics.Paint;
+import android.hardware.SensorManager;
 import android.util.AttributeSet;
 import android.util.Log;
 
@@ -25,8 +32,40 @@ public class CameraView extends AbstractCameraView {
 	public boolean MODE_OPENCVCALIB = true;
 	public boolean MODE_USEONLYIMU  = true;
 	public boolean MODE_CHESSBHORZ = true;
+	public boolean MODE_TRACKVANISHPT = true;
+	public boolean MODE_PARALLELVANISHPT = false;
+	// detection on the native worker keeps the preview callback to a frame copy;
+	// with one grab at a time, a result that is not ready yet is shown at the next grab
+	public boolean MODE_ASYNCPIPELINE = true;
+	public boolean MODE_CANVASOVERLAY = true;
+	public boolean MODE_ONLINECALIB = true;
+	public boolean MODE_SESSIONLOG = false;
+	public boolean MODE_RECORDFRAMES = false;
+	public boolean MODE_KEYFRAMES = true;
+	public boolean MODE_ONLINEINTRINSICS = true;
+	public boolean MODE_BUFFERTRANSFER = true;
+	public boolean MODE_BENCHMARKJNI = false;
+	public boolean MODE_PARTIALBOARDS = true;
+	// vanishing point engines, as in VanishingPointEngine.h
+	public static final int VP_ENGINE_RANSAC = 0;
+	public static final int VP_ENGINE_CAS1D = 1;
+	public int vanishingPointEngine = VP_ENGINE_RANSAC;
 	public int checkerRows = 6;
 	public int checkerCols = 9;
+	public int boardsPerFrame = 1;
+	// a second board size that may be in view, 0 for none
+	public int otherCheckerRows = 0;
+	public int otherCheckerCols = 0;
+	// doubles written by getFrameState, see MutualCalibration.cpp
+	public static final int FRAME_STATE_SIZE = 27;
+	
+	// sensor samples, flushed to the native ring buffer once per frame
+	public final IMUSampleBatch imuBatch = new IMUSampleBatch(64);
+	private final ByteBuffer mFrameState = ByteBuffer.allocateDirect(FRAME_STATE_SIZE * 8)
+			.order(ByteOrder.nativeOrder());
+	private final DoubleBuffer mFrameStateValues = mFrameState.asDoubleBuffer();
+	// rotation vector at the previous vanishing point frame
+	private float[] mLastRotationVector;
 	
 	
     private Mat mYuv;
@@ -58,15 +97,56 @@ public class CameraView extends AbstractCameraView {
 	@Override
 	public void grabAndProcess(){
 		// initialize calibration object
-		if(calibrationObject == null)
-		calibrationObject = new MutualCalibration(getFrameHeight(), getFrameWidth(), checkerRows, 
-				checkerCols, MODE_USEOPENCVCORNER, MODE_USEONLYIMU, MODE_USERANSCA);
+		if(calibrationObject == null){
+			calibrationObject = new MutualCalibration(getFrameHeight(), getFrameWidth(), checkerRows, 
+					checkerCols, MODE_USEOPENCVCORNER, MODE_USEONLYIMU, MODE_USERANSCA);
+			calibrationObject.setVanishingPointTracking(MODE_TRACKVANISHPT);
+			calibrationObject.setVanishingPointEngine(vanishingPointEngine);
+			calibrationObject.setParallelVanishingPointEngines(MODE_PARALLELVANISHPT);
+			// a unified projection model of the camera, as written by CataCameraParameters,
+			// lets the vanishing point engines work on undistorted lines
+			if(calibrationObject.loadCameraParameters(getDataFolder() + "/camera_parameters.yaml"))
+				Log.i(TAG, "Vanishing points use the camera parameters in camera_parameters.yaml");
+			// detections are drawn here on the bitmap instead of natively on the frame
+			calibrationObject.setOverlayDrawing(!MODE_CANVASOVERLAY);
+			calibrationObject.setIncrementalCalibration(MODE_ONLINECALIB);
+			// near duplicate chessboard views are not added
+			calibrationObject.setKeyframeSelection(MODE_KEYFRAMES);
+			// with several boards in view, each is added as a view of its own
+			calibrationObject.setBoardsPerFrame(boardsPerFrame);
+			// boards of another size are looked for in the same detection
+			if(otherCheckerRows > 0 && otherCheckerCols > 0)
+				calibrationObject.addBoardSize(otherCheckerRows, otherCheckerCols);
+			// a board with rows or columns cut off by the image border is still used
+			calibrationObject.setPartialBoards(MODE_PARTIALBOARDS);
+			// K is refined with every chessboard view instead of only in calibrateCamera
+			calibrationObject.setIncrementalIntrinsics(MODE_ONLINEINTRINSICS);
+			// accepted observations, for re-running the calibration offline with replaySession;
+			// one file per session, named after the time the activity was created
+			if(MODE_SESSIONLOG && !calibrationObject.startSessionLog(getDataFolder() + "/session_"
+					+ CalibrationActivity.filePathUniqueIdentifier + ".bin"))
+				Log.e(TAG, "Could not open the session log");
+			// raw gray frames for benchmarking the detectors, played back by jni/main.cpp
+			if(MODE_RECORDFRAMES && !calibrationObject.startFrameRecording(getDataFolder() + "/frames.bin"))
+				Log.e(TAG, "Could not open the frame recording");
+			// cost of the JNI calls made per frame, see JniBenchmark
+			if(MODE_BENCHMARKJNI)
+				JniBenchmark.run(getFrameHeight(), getFrameWidth(), checkerRows, checkerCols);
+		}
+		// detection runs on a native worker, the preview thread only enqueues
+		if(MODE_ASYNCPIPELINE)
+			calibrationObject.startFramePipeline();
 		super.grabAndProcess();
 	}
 	
 	@Override
 	protected void onPreviewStopped() {
 		
+		if (calibrationObject != null) {
+			calibrationObject.stopFramePipeline();
+			calibrationObject.stopFrameRecording();
+		}
+
 		if (mBitmap != null) {
 			mBitmap.recycle();
 			mBitmap = null;
@@ -87,17 +167,59 @@ public class CameraView extends AbstractCameraView {
 	
     @Override
     protected Bitmap processFrame(byte[] data) {
+    	// preview callbacks carry no exposure time, so the frame is stamped on
+    	// arrival, a few tens of milliseconds after the exposure; converted to the
+    	// sensor event clock, which is not System.nanoTime() on every device
+    	long timestamp = CalibrationActivity.sensorClock.toSensorTime(System.nanoTime());
+    	if (!CalibrationActivity.sensorClock.isValid())
+    		Log.w(TAG, "No sensor event yet, frame stamped on the System.nanoTime() clock");
     	float[] afterSensor = CalibrationActivity.latestSensor;
     	float[] sensorValue = interpSensor(CalibrationActivity.beforeSensor, afterSensor);
-        mYuv.put(0, 0, data);
-        Imgproc.cvtColor(mYuv, mRgba, Imgproc.COLOR_YUV420sp2RGB, 4);
         boolean success;
+        // the samples received since the last frame, in one call
+        if (MODE_BUFFERTRANSFER)
+        	imuBatch.flush(calibrationObject);
+        // the device rotation since the previous vanishing point frame predicts
+        // where the tracked vanishing points moved
+        if (MODE_TRACKVANISHPT && CalibrationActivity.globalMode != CalibrationActivity.MODE_CHECKERBOARD)
+        	setRotationDelta(CalibrationActivity.latestRotationVector);
+        
+        if (MODE_RECORDFRAMES)
+        	calibrationObject.recordNV21Frame(data, CalibrationActivity.globalMode, timestamp,
+        			(double)sensorValue[0], (double)sensorValue[1], (double)sensorValue[2]);
         
-        // Native code call
-        if (CalibrationActivity.globalMode == CalibrationActivity.MODE_CHECKERBOARD)
-        	success = calibrationObject.tryAddingChessboardImage(mGraySubmat.getNativeObjAddr(), mRgba.getNativeObjAddr());
-        else{
-        	success = calibrationObject.tryAddingVanishingPointImage(mGraySubmat.getNativeObjAddr(), mRgba.getNativeObjAddr());
+        if (MODE_ASYNCPIPELINE) {
+        	// globalMode matches PIPELINE_MODE_* in FramePipeline.h; the raw frame is
+        	// converted on the worker and the result shown is the latest one it finished
+        	calibrationObject.enqueueTimedNV21Frame(data, CalibrationActivity.globalMode, timestamp,
+        			(double)sensorValue[0], (double)sensorValue[1], (double)sensorValue[2]);
+        	if (calibrationObject.pollFrameResult(mRgba.getNativeObjAddr()) >= 0) {
+        		// enqueued, dropped, processed, accepted
+        		double[] stats = new double[4];
+        		calibrationObject.getFramePipelineStats(stats);
+        		Log.i(TAG, String.format("pipeline: %.0f enqueued, %.0f dropped, %.0f processed, %.0f accepted",
+        				stats[0], stats[1], stats[2], stats[3]));
+        	} else if (mRgba.empty()) {
+        		// nothing processed yet, show the plain frame
+        		mYuv.put(0, 0, data);
+        		Imgproc.cvtColor(mYuv, mRgba, Imgproc.COLOR_YUV420sp2RGB, 4);
+        	}
+        	return showFrame();
+        }
+
+        // Native code call, detection runs on the Y plane and the detections are
+        // drawn on the single rgba conversion
+        success = calibrationObject.tryAddingNV21Image(data, CalibrationActivity.globalMode, mRgba.getNativeObjAddr());
+        if (CalibrationActivity.globalMode != CalibrationActivity.MODE_CHECKERBOARD) {
+        	
+        	// per engine: success, tracked, lines, support, milliseconds, pairs tested,
+        	// pairs rejected; then the engine used
+        	double[] stats = new double[15];
+        	calibrationObject.getVanishingPointStats(stats);
+        	Log.i(TAG, String.format("VP engine %d: ransac %.0f lines %.0f support %.1f ms %.0f/%.0f pairs rejected, " +
+        			"cas1d %.0f lines %.0f support %.1f ms %.0f/%.0f pairs rejected",
+        			(int)stats[14], stats[2], stats[3], stats[4], stats[6], stats[5],
+        			stats[9], stats[10], stats[11], stats[13], stats[12]));
         	
         	//also save the before and after images
 //        	Bitmap before = Bitmap.createBitmap(getFrameWidth(), getFrameHeight(), Bitmap.Config.ARGB_8888);
@@ -114,11 +236,20 @@ public class CameraView extends AbstractCameraView {
 //			}
         }
         if (success){
+        	// the IMU at the frame time, or the averaged reading if the buffer does not cover it
+        	double[] imu = new double[3];
+        	if (!calibrationObject.getIMUAtTimestamp(timestamp, imu))
+        		for (int j = 0; j < 3; j++)
+        			imu[j] = sensorValue[j];
         	if(MODE_USEONLYIMU)
-        		calibrationObject.addIMUGravityVector((double)sensorValue[0], (double)sensorValue[1], (double)sensorValue[2]);
+        		calibrationObject.addIMUGravityVector(imu[0], imu[1], imu[2]);
         	else
-        		calibrationObject.addFullIMURotationByQuaternion((double)sensorValue[0], (double)sensorValue[1], (double)sensorValue[2]);
+        		calibrationObject.addFullIMURotationByQuaternion(imu[0], imu[1], imu[2]);
         }
+        return showFrame();
+    }
+    
+    private Bitmap showFrame() {
         Bitmap bmp = mBitmap;
         try {
             Utils.matToBitmap(mRgba, bmp);
@@ -127,10 +258,96 @@ public class CameraView extends AbstractCameraView {
             bmp.recycle();
             bmp = null;
         }
+        if (MODE_CANVASOVERLAY && bmp != null)
+        	drawOverlay(bmp);
+        if (MODE_BUFFERTRANSFER) {
+        	showFrameState();
+        	return bmp;
+        }
         CalibrationActivity.updateUI(CalibrationActivity.IMAGES_TXT, calibrationObject.getNumberOfImages(), null);
+        if (MODE_ONLINECALIB) {
+        	// live camera to IMU rotation, shown once the gravity directions are diverse enough
+        	double[] rotation = new double[9];
+        	if (calibrationObject.getOnlineRotationMatrix(rotation))
+        		CalibrationActivity.displayMatrix(0, rotation);
+        	Log.i(TAG, String.format("online calibration conditioning %.3f", calibrationObject.getOnlineConditioning()));
+        }
+        if (MODE_ONLINEINTRINSICS) {
+        	// live camera matrix, shown once a few chessboard views are in
+        	double[] camera = new double[9];
+        	if (calibrationObject.getOnlineCameraMatrix(camera)) {
+        		CalibrationActivity.displayMatrix(1, camera);
+        		Log.i(TAG, String.format("online intrinsics rms %.3f px", calibrationObject.getOnlineReprojectionError()));
+        	}
+        }
         return bmp;
     }
     
+    private void showFrameState() {
+    	// what showFrame reads, in one call; layout as in MutualCalibration::getFrameState
+    	calibrationObject.getFrameState(mFrameState);
+    	double[] state = new double[FRAME_STATE_SIZE];
+    	mFrameStateValues.get(state, 0, FRAME_STATE_SIZE);
+    	mFrameStateValues.rewind();
+    	CalibrationActivity.updateUI(CalibrationActivity.IMAGES_TXT, (long)state[0], null);
+    	if (MODE_ONLINECALIB) {
+    		double[] rotation = new double[9];
+    		System.arraycopy(state, 2, rotation, 0, 9);
+    		if (state[1] != 0.0)
+    			CalibrationActivity.displayMatrix(0, rotation);
+    		Log.i(TAG, String.format("online calibration conditioning %.3f", state[11]));
+    	}
+    	if (MODE_ONLINEINTRINSICS && state[12] != 0.0) {
+    		double[] camera = new double[9];
+    		System.arraycopy(state, 13, camera, 0, 9);
+    		CalibrationActivity.displayMatrix(1, camera);
+    		Log.i(TAG, String.format("online intrinsics rms %.3f px", state[22]));
+    	}
+    }
+    
+    private void setRotationDelta(float[] rotationVector) {
+    	if (rotationVector != null && mLastRotationVector != null) {
+    		// quaternions as w x y z; the delta is conj(current) * previous, the
+    		// rotation from the previous device frame to the current one
+    		float[] q0 = new float[4];
+    		float[] q1 = new float[4];
+    		SensorManager.getQuaternionFromVector(q0, mLastRotationVector);
+    		SensorManager.getQuaternionFromVector(q1, rotationVector);
+    		double w = q1[0] * q0[0] + q1[1] * q0[1] + q1[2] * q0[2] + q1[3] * q0[3];
+    		double x = q1[0] * q0[1] - q1[1] * q0[0] - q1[2] * q0[3] + q1[3] * q0[2];
+    		double y = q1[0] * q0[2] - q1[2] * q0[0] - q1[3] * q0[1] + q1[1] * q0[3];
+    		double z = q1[0] * q0[3] - q1[3] * q0[0] - q1[1] * q0[2] + q1[2] * q0[1];
+    		// the native side takes the vector part only, so w must not be negative
+    		double sign = w < 0 ? -1.0 : 1.0;
+    		calibrationObject.setIMURotationDelta(sign * x, sign * y, sign * z);
+    	}
+    	mLastRotationVector = rotationVector;
+    }
+    
+    private void drawOverlay(Bitmap bmp) {
+    	// layout as in Overlay.h: number of points and segments, then x y r g b radius
+    	// per point and x0 y0 x1 y1 r g b thickness per segment
+    	float[] overlay = new float[(int)calibrationObject.getOverlaySize()];
+    	calibrationObject.getOverlay(overlay);
+    	Canvas canvas = new Canvas(bmp);
+    	Paint paint = new Paint();
+    	paint.setAntiAlias(true);
+    	paint.setStyle(Paint.Style.STROKE);
+    	int points = (int)overlay[0];
+    	int segments = (int)overlay[1];
+    	int k = 2;
+    	for (int i = 0; i < points; i++, k += 6) {
+    		paint.setColor(Color.rgb((int)overlay[k + 2], (int)overlay[k + 3], (int)overlay[k + 4]));
+    		paint.setStrokeWidth(1);
+    		canvas.drawCircle(overlay[k], overlay[k + 1], overlay[k + 5], paint);
+    	}
+    	for (int i = 0; i < segments; i++, k += 8) {
+    		paint.setColor(Color.rgb((int)overlay[k + 4], (int)overlay[k + 5], (int)overlay[k + 6]));
+    		paint.setStrokeWidth(overlay[k + 7]);
+    		canvas.drawLine(overlay[k], overlay[k + 1], overlay[k + 2], overlay[k + 3], paint);
+    	}
+    }
+    
     @Override
     protected float[] saveSensorData(){
     	float[] afterSensor = CalibrationActivity.latestSensor;
@@ -0,0 +1,43 @@
+package cvg.sfmPipeline.calibration;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * Sensor samples collected on the sensor thread and handed to the native ring
+ * buffer in one call per frame. The records match IMUSample in IMURingBuffer.h:
+ * timestamp, then three values, in native byte order.
+ */
+public class IMUSampleBatch {
+    public static final int SAMPLE_SIZE = 32;
+    
+    private final ByteBuffer mBuffer;
+    private final int mCapacity;
+    private int mCount = 0;
+    
+    public IMUSampleBatch(int capacity) {
+        mCapacity = capacity;
+        mBuffer = ByteBuffer.allocateDirect(capacity * SAMPLE_SIZE).order(ByteOrder.nativeOrder());
+    }
+    
+    public synchronized void add(MutualCalibration calibration, long timestamp, float x, float y, float z) {
+        // a full batch is flushed from here, so that no sample is lost if
+        // frames stop coming
+        if (mCount == mCapacity)
+            flush(calibration);
+        int offset = mCount * SAMPLE_SIZE;
+        mBuffer.putLong(offset, timestamp);
+        mBuffer.putDouble(offset + 8, x);
+        mBuffer.putDouble(offset + 16, y);
+        mBuffer.putDouble(offset + 24, z);
+        mCount++;
+    }
+    
+    public synchronized int flush(MutualCalibration calibration) {
+        int added = 0;
+        if (mCount > 0 && calibration != null)
+            added = calibration.addIMUSamples(mBuffer, mCount);
+        mCount = 0;
+        return added;
+    }
+}
@@ -0,0 +1,82 @@
+package cvg.sfmPipeline.calibration;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+import android.util.Log;
+
+/**
+ * Cost of the JNI transitions: the per sample and per matrix calls against
+ * the batched ByteBuffer ones, on a throwaway calibration object so that the
+ * running one is not affected. Results go to the log in ns.
+ */
+public class JniBenchmark {
+    private static final String TAG = "Calibration::JniBenchmark";
+    
+    public static void run(int height, int width, int rows, int cols) {
+        MutualCalibration calibration = new MutualCalibration(height, width, rows, cols, true, true, false);
+        final int samples = 20000;
+        final int batch = 8;
+        final int reads = 5000;
+        
+        // warm up, the first calls resolve the native methods
+        calibration.addIMUSample(0, 0.0, 0.0, 9.81);
+        
+        long start = System.nanoTime();
+        for (int i = 0; i < samples; i++)
+            calibration.addIMUSample(i, 0.0, 0.0, 9.81);
+        double single = (System.nanoTime() - start) / (double)samples;
+        
+        IMUSampleBatch imu = new IMUSampleBatch(batch);
+        start = System.nanoTime();
+        for (int i = 0; i < samples; i++) {
+            imu.add(calibration, samples + i, 0.0f, 0.0f, 9.81f);
+            if (i % batch == batch - 1)
+                imu.flush(calibration);
+        }
+        imu.flush(calibration);
+        double batched = (System.nanoTime() - start) / (double)samples;
+        Log.i(TAG, String.format("imu: %.0f ns per sample one by one, %.0f ns per sample in batches of %d",
+                single, batched, batch));
+        
+        double[] rotation = new double[9];
+        double[] camera = new double[9];
+        start = System.nanoTime();
+        for (int i = 0; i < reads; i++) {
+            calibration.getRotationMatrix(rotation);
+            calibration.getCameraMatrix(camera);
+        }
+        double arrays = (System.nanoTime() - start) / (double)reads;
+        
+        ByteBuffer results = ByteBuffer.allocateDirect(18 * 8).order(ByteOrder.nativeOrder());
+        start = System.nanoTime();
+        for (int i = 0; i < reads; i++)
+            calibration.getCalibrationResults(results);
+        double buffer = (System.nanoTime() - start) / (double)reads;
+        Log.i(TAG, String.format("results: %.0f ns with two double[] calls, %.0f ns with one ByteBuffer call",
+                arrays, buffer));
+        
+        // the calls showFrame makes after every frame
+        double[] stats = new double[4];
+        start = System.nanoTime();
+        for (int i = 0; i < reads; i++) {
+            calibration.getNumberOfImages();
+            calibration.getOnlineRotationMatrix(rotation);
+            calibration.getOnlineConditioning();
+            calibration.getOnlineCameraMatrix(camera);
+            calibration.getOnlineReprojectionError();
+            calibration.getFramePipelineStats(stats);
+        }
+        arrays = (System.nanoTime() - start) / (double)reads;
+        
+        ByteBuffer state = ByteBuffer.allocateDirect(CameraView.FRAME_STATE_SIZE * 8).order(ByteOrder.nativeOrder());
+        start = System.nanoTime();
+        for (int i = 0; i < reads; i++)
+            calibration.getFrameState(state);
+        buffer = (System.nanoTime() - start) / (double)reads;
+        Log.i(TAG, String.format("frame state: %.0f ns with six calls, %.0f ns with one ByteBuffer call",
+                arrays, buffer));
+        
+        calibration.delete();
+    }
+}
@@ -59,6 +59,22 @@ public class MutualCalibration {
     return CalibrationJNI.MutualCalibration_tryAddingVanishingPointImage(swigCPtr, this, (inputImage), (outputImage));
   }
 
+  public boolean tryAddingNV21Image(byte[] nv21, int mode, long outputImage) {
+    return CalibrationJNI.MutualCalibration_tryAddingNV21Image(swigCPtr, this, nv21, mode, (outputImage));
+  }
+
+  public void setOverlayDrawing(boolean enable) {
+    CalibrationJNI.MutualCalibration_setOverlayDrawing(swigCPtr, this, enable);
+  }
+
+  public long getOverlaySize() {
+    return CalibrationJNI.MutualCalibration_getOverlaySize(swigCPtr, this);
+  }
+
+  public void getOverlay(float[] p) {
+    CalibrationJNI.MutualCalibration_getOverlay(swigCPtr, this, p);
+  }
+
   public void addFullIMURotationByQuaternion(double r0, double r1, double r2) {
     CalibrationJNI.MutualCalibration_addFullIMURotationByQuaternion(swigCPtr, this, r0, r1, r2);
   }
@@ -67,18 +83,206 @@ public class MutualCalibration {
     CalibrationJNI.MutualCalibration_addIMUGravityVector(swigCPtr, this, g1, g2, g3);
   }
 
+  public void addIMUSample(long timestamp, double x, double y, double z) {
+    CalibrationJNI.MutualCalibration_addIMUSample(swigCPtr, this, timestamp, x, y, z);
+  }
+
+  public void setIMUTimeConstant(double seconds) {
+    CalibrationJNI.MutualCalibration_setIMUTimeConstant(swigCPtr, this, seconds);
+  }
+
+  public boolean getIMUAtTimestamp(long timestamp, double[] p) {
+    return CalibrationJNI.MutualCalibration_getIMUAtTimestamp(swigCPtr, this, timestamp, p);
+  }
+
+  public void setVanishingPointTracking(boolean enable) {
+    CalibrationJNI.MutualCalibration_setVanishingPointTracking(swigCPtr, this, enable);
+  }
+
+  public void setIMURotationDelta(double r0, double r1, double r2) {
+    CalibrationJNI.MutualCalibration_setIMURotationDelta(swigCPtr, this, r0, r1, r2);
+  }
+
+  public void setVanishingPointEngine(int engine) {
+    CalibrationJNI.MutualCalibration_setVanishingPointEngine(swigCPtr, this, engine);
+  }
+
+  public void setParallelVanishingPointEngines(boolean enable) {
+    CalibrationJNI.MutualCalibration_setParallelVanishingPointEngines(swigCPtr, this, enable);
+  }
+
+  public void getVanishingPointStats(double[] p) {
+    CalibrationJNI.MutualCalibration_getVanishingPointStats(swigCPtr, this, p);
+  }
+
+  public boolean setCameraParameters(int width, int height, double xi, double k1, double k2, double p1, double p2, double gamma1, double gamma2, double u0, double v0) {
+    return CalibrationJNI.MutualCalibration_setCameraParameters(swigCPtr, this, width, height, xi, k1, k2, p1, p2, gamma1, gamma2, u0, v0);
+  }
+
+  public boolean loadCameraParameters(String path) {
+    return CalibrationJNI.MutualCalibration_loadCameraParameters(swigCPtr, this, path);
+  }
+
+  public void setLogLevel(int level) {
+    CalibrationJNI.MutualCalibration_setLogLevel(swigCPtr, this, level);
+  }
+
+  public boolean startFramePipeline() {
+    return CalibrationJNI.MutualCalibration_startFramePipeline(swigCPtr, this);
+  }
+
+  public void stopFramePipeline() {
+    CalibrationJNI.MutualCalibration_stopFramePipeline(swigCPtr, this);
+  }
+
+  public boolean enqueueFrame(long inputImage, long outputImage, int mode, double s0, double s1, double s2) {
+    return CalibrationJNI.MutualCalibration_enqueueFrame(swigCPtr, this, (inputImage), (outputImage), mode, s0, s1, s2);
+  }
+
+  public boolean enqueueNV21Frame(byte[] nv21, int mode, double s0, double s1, double s2) {
+    return CalibrationJNI.MutualCalibration_enqueueNV21Frame(swigCPtr, this, nv21, mode, s0, s1, s2);
+  }
+
+  public boolean enqueueTimedNV21Frame(byte[] nv21, int mode, long timestamp, double s0, double s1, double s2) {
+    return CalibrationJNI.MutualCalibration_enqueueTimedNV21Frame(swigCPtr, this, nv21, mode, timestamp, s0, s1, s2);
+  }
+
+  public int pollFrameResult(long outputImage) {
+    return CalibrationJNI.MutualCalibration_pollFrameResult(swigCPtr, this, (outputImage));
+  }
+
+  public void getFramePipelineStats(double[] p) {
+    CalibrationJNI.MutualCalibration_getFramePipelineStats(swigCPtr, this, p);
+  }
+
+  public void setSquareSize(float size) {
+    CalibrationJNI.MutualCalibration_setSquareSize(swigCPtr, this, size);
+  }
+
+  public void setBoardsPerFrame(int boards) {
+    CalibrationJNI.MutualCalibration_setBoardsPerFrame(swigCPtr, this, boards);
+  }
+
+  public void addBoardSize(int heightBoard, int widthBoard) {
+    CalibrationJNI.MutualCalibration_addBoardSize(swigCPtr, this, heightBoard, widthBoard);
+  }
+
+  public void setPartialBoards(boolean enable) {
+    CalibrationJNI.MutualCalibration_setPartialBoards(swigCPtr, this, enable);
+  }
+
+  public void setKeyframeSelection(boolean enable) {
+    CalibrationJNI.MutualCalibration_setKeyframeSelection(swigCPtr, this, enable);
+  }
+
+  public void getKeyframeStats(double[] p) {
+    CalibrationJNI.MutualCalibration_getKeyframeStats(swigCPtr, this, p);
+  }
+
+  public void setIncrementalIntrinsics(boolean enable) {
+    CalibrationJNI.MutualCalibration_setIncrementalIntrinsics(swigCPtr, this, enable);
+  }
+
+  public boolean getOnlineCameraMatrix(double[] p) {
+    return CalibrationJNI.MutualCalibration_getOnlineCameraMatrix(swigCPtr, this, p);
+  }
+
+  public double getOnlineReprojectionError() {
+    return CalibrationJNI.MutualCalibration_getOnlineReprojectionError(swigCPtr, this);
+  }
+
+  public void setViewErrorThreshold(double pixels) {
+    CalibrationJNI.MutualCalibration_setViewErrorThreshold(swigCPtr, this, pixels);
+  }
+
+  public void getViewRefinementStats(double[] p) {
+    CalibrationJNI.MutualCalibration_getViewRefinementStats(swigCPtr, this, p);
+  }
+
+  public boolean startSessionLog(String path) {
+    return CalibrationJNI.MutualCalibration_startSessionLog(swigCPtr, this, path);
+  }
+
+  public void stopSessionLog() {
+    CalibrationJNI.MutualCalibration_stopSessionLog(swigCPtr, this);
+  }
+
+  public boolean replaySession(String path) {
+    return CalibrationJNI.MutualCalibration_replaySession(swigCPtr, this, path);
+  }
+
+  public boolean saveCalibration(String path) {
+    return CalibrationJNI.MutualCalibration_saveCalibration(swigCPtr, this, path);
+  }
+
+  public boolean loadCalibration(String path) {
+    return CalibrationJNI.MutualCalibration_loadCalibration(swigCPtr, this, path);
+  }
+
+  public int addIMUSamples(java.nio.ByteBuffer buffer, int count) {
+    return CalibrationJNI.MutualCalibration_addIMUSamples(swigCPtr, this, buffer, count);
+  }
+
+  public boolean addChessboardCorners(java.nio.ByteBuffer buffer, long timestamp) {
+    return CalibrationJNI.MutualCalibration_addChessboardCorners(swigCPtr, this, buffer, timestamp);
+  }
+
+  public int getChessboardCorners(int view, java.nio.ByteBuffer buffer) {
+    return CalibrationJNI.MutualCalibration_getChessboardCorners(swigCPtr, this, view, buffer);
+  }
+
+  public boolean getCalibrationResults(java.nio.ByteBuffer buffer) {
+    return CalibrationJNI.MutualCalibration_getCalibrationResults(swigCPtr, this, buffer);
+  }
+
+  public boolean getFrameState(java.nio.ByteBuffer buffer) {
+    return CalibrationJNI.MutualCalibration_getFrameState(swigCPtr, this, buffer);
+  }
+
+  public boolean startFrameRecording(String path) {
+    return CalibrationJNI.MutualCalibration_startFrameRecording(swigCPtr, this, path);
+  }
+
+  public void stopFrameRecording() {
+    CalibrationJNI.MutualCalibration_stopFrameRecording(swigCPtr, this);
+  }
+
+  public boolean recordNV21Frame(byte[] nv21, int mode, long timestamp, double s0, double s1, double s2) {
+    return CalibrationJNI.MutualCalibration_recordNV21Frame(swigCPtr, this, nv21, mode, timestamp, s0, s1, s2);
+  }
+
   public long getNumberOfImages() {
     return CalibrationJNI.MutualCalibration_getNumberOfImages(swigCPtr, this);
   }
 
+  public double getFocalConfidence() {
+    return CalibrationJNI.MutualCalibration_getFocalConfidence(swigCPtr, this);
+  }
+
   public void getRotationMatrix(double[] p) {
     CalibrationJNI.MutualCalibration_getRotationMatrix(swigCPtr, this, p);
   }
 
+  public void setIncrementalCalibration(boolean enable) {
+    CalibrationJNI.MutualCalibration_setIncrementalCalibration(swigCPtr, this, enable);
+  }
+
+  public boolean getOnlineRotationMatrix(double[] p) {
+    return CalibrationJNI.MutualCalibration_getOnlineRotationMatrix(swigCPtr, this, p);
+  }
+
+  public double getOnlineConditioning() {
+    return CalibrationJNI.MutualCalibration_getOnlineConditioning(swigCPtr, this);
+  }
+
   public void getCameraMatrix(double[] p) {
     CalibrationJNI.MutualCalibration_getCameraMatrix(swigCPtr, this, p);
   }
 
+  public void getRansacStats(double[] p) {
+    CalibrationJNI.MutualCalibration_getRansacStats(swigCPtr, this, p);
+  }
+
   public void calibrateCamera() {
     CalibrationJNI.MutualCalibration_calibrateCamera(swigCPtr, this);
   }
@@ -0,0 +1,37 @@
+package cvg.sfmPipeline.calibration;
+
+/**
+ * Offset between the clock of SensorEvent.timestamp and System.nanoTime().
+ * Depending on the device, sensor events are stamped with System.nanoTime() or
+ * with elapsedRealtimeNanos(), which also counts deep sleep, so preview frames
+ * stamped on arrival are converted before they are matched to sensor samples.
+ * Every event arrives some delivery latency after its timestamp; the largest
+ * timestamp - arrival difference seen is the one with the least latency.
+ */
+public class SensorClock {
+    // a larger change means the clocks moved apart, e.g. after a sleep
+    private static final long MAX_JUMP = 1000000000L;
+    
+    private long mOffset = 0;
+    private boolean mValid = false;
+    
+    public synchronized void update(long eventTimestamp) {
+        long offset = eventTimestamp - System.nanoTime();
+        if (!mValid || offset > mOffset || mOffset - offset > MAX_JUMP)
+            mOffset = offset;
+        mValid = true;
+    }
+    
+    public synchronized boolean isValid() {
+        return mValid;
+    }
+    
+    public synchronized long getOffset() {
+        return mOffset;
+    }
+    
+    // the sensor clock time of a System.nanoTime() value
+    public synchronized long toSensorTime(long nanoTime) {
+        return nanoTime + mOffset;
+    }
+}